@@ -0,0 +1,34 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "core/allocator_benchmark.h"
+
+using namespace CHULUBME;
+
+// Usage: allocator_benchmark [--passes N] [--threads N[,N...]]
+int main(int argc, char** argv) {
+    AllocatorBenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            options.passes = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            options.threadCounts.clear();
+            for (char* cursor = argv[++i]; *cursor;) {
+                char* end = cursor;
+                uint32_t threads = static_cast<uint32_t>(std::strtoul(cursor, &end, 10));
+                if (end == cursor) {
+                    break;
+                }
+                options.threadCounts.push_back(threads);
+                cursor = *end == ',' ? end + 1 : end;
+            }
+        } else {
+            std::fprintf(stderr, "usage: %s [--passes N] [--threads N[,N...]]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    AllocatorBenchmark benchmark = AllocatorBenchmark::CreateDefault(options);
+    std::fputs(AllocatorBenchmark::Format(benchmark.Run()).c_str(), stdout);
+    return 0;
+}
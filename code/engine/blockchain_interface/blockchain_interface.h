@@ -3,12 +3,16 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <functional>
 #include <unordered_map>
 #include "../core/ecs.h"
 
 namespace CHULUBME {
 
+// Forward declarations
+class JobSystem;
+
 /**
  * @brief Interface for communicating with the blockchain
  */
@@ -54,11 +58,19 @@ public:
         std::string address;
         std::string publicKey;
         double balance;
-        std::vector<NFT> nfts;
+        std::pmr::vector<NFT> nfts; // construct with a memory resource to keep a wallet's NFTs in a world's allocators
         std::vector<std::string> transactions;
         int64_t createdAt;
         int64_t lastUpdated;
     };
+    
+    // Per-player match result used for reward calculation
+    struct GameResult {
+        int64_t matchDuration;
+        int playerRank;
+        double performanceScore;
+        int activePlayerCount;
+    };
 
 private:
     // Singleton instance
@@ -166,6 +178,9 @@ public:
     
     // Calculate game reward
     double CalculateGameReward(int64_t matchDuration, int playerRank, double performanceScore, int activePlayerCount);
+    
+    // Calculate game rewards for a batch of results in parallel on the job system (one reward per result)
+    std::vector<double> CalculateGameRewards(const std::vector<GameResult>& results, JobSystem& jobSystem);
 };
 
 /**
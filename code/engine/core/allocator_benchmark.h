@@ -0,0 +1,602 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "memory.h"
+
+namespace CHULUBME {
+
+/**
+ * @brief A recorded or synthesized sequence of allocation events to replay against allocators
+ *
+ * Every allocation is addressed by a slot so the trace can be replayed
+ * without knowing the pointers an allocator returns. EndFrame releases
+ * everything still live in bulk: allocators with a Reset use it, the rest
+ * free each live block. The builder tracks whether frees always hit the
+ * most recent live allocation, since stack allocators can only replay such
+ * traces.
+ */
+class AllocationTrace {
+public:
+    enum class OpType : uint8_t {
+        Allocate,
+        Free,
+        EndFrame
+    };
+
+    struct Op {
+        OpType type;
+        uint32_t slot;
+        uint32_t size;
+    };
+
+private:
+    std::string m_name;
+    std::vector<Op> m_ops;
+    std::vector<uint32_t> m_slotSizes;
+    std::vector<uint32_t> m_freeSlots;
+    std::vector<uint8_t> m_slotLive;
+    // Live slots in allocation order, kept only while the trace is still LIFO
+    std::vector<uint32_t> m_liveStack;
+    uint32_t m_maxSize;
+    uint64_t m_allocationCount;
+    bool m_hasFrees;
+    bool m_hasFrames;
+    bool m_lifo;
+
+public:
+    explicit AllocationTrace(std::string name)
+        : m_name(std::move(name)), m_maxSize(0), m_allocationCount(0), m_hasFrees(false), m_hasFrames(false), m_lifo(true) {}
+
+    // Record an allocation; returns the slot that identifies it
+    uint32_t Allocate(uint32_t size) {
+        uint32_t slot;
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(m_slotSizes.size());
+            m_slotSizes.push_back(0);
+            m_slotLive.push_back(0);
+        }
+        m_slotSizes[slot] = size;
+        m_slotLive[slot] = 1;
+        if (m_lifo) {
+            m_liveStack.push_back(slot);
+        }
+        m_ops.push_back(Op{OpType::Allocate, slot, size});
+        m_maxSize = std::max(m_maxSize, size);
+        ++m_allocationCount;
+        return slot;
+    }
+
+    // Record freeing the allocation in a slot
+    void Free(uint32_t slot) {
+        if (m_lifo && m_liveStack.back() == slot) {
+            m_liveStack.pop_back();
+        } else {
+            m_lifo = false;
+            m_liveStack.clear();
+        }
+        m_slotLive[slot] = 0;
+        m_ops.push_back(Op{OpType::Free, slot, m_slotSizes[slot]});
+        m_freeSlots.push_back(slot);
+        m_hasFrees = true;
+    }
+
+    // Record a frame boundary: everything still live is released in bulk
+    void EndFrame() {
+        m_ops.push_back(Op{OpType::EndFrame, 0, 0});
+        for (uint32_t slot = 0; slot < m_slotLive.size(); ++slot) {
+            if (m_slotLive[slot]) {
+                m_slotLive[slot] = 0;
+                m_freeSlots.push_back(slot);
+            }
+        }
+        m_liveStack.clear();
+        m_hasFrames = true;
+    }
+
+    const std::string& GetName() const { return m_name; }
+    const std::vector<Op>& GetOps() const { return m_ops; }
+
+    // Get the number of slots a replay needs
+    uint32_t GetSlotCount() const { return static_cast<uint32_t>(m_slotSizes.size()); }
+
+    // Get the largest allocation size
+    uint32_t GetMaxSize() const { return m_maxSize; }
+
+    // Get the number of allocations
+    uint64_t GetAllocationCount() const { return m_allocationCount; }
+
+    // Check if the trace frees blocks individually (rather than only at frame ends)
+    bool HasFrees() const { return m_hasFrees; }
+
+    // Check if the trace has frame boundaries
+    bool HasFrames() const { return m_hasFrames; }
+
+    // Check if every free releases the most recent live allocation
+    bool IsLifo() const { return m_lifo; }
+};
+
+// Allocate and immediately free size-byte blocks, count times (best case for every allocator)
+inline AllocationTrace MakeChurnTrace(uint32_t size = 64, uint32_t count = 200000) {
+    AllocationTrace trace("churn " + std::to_string(size) + "B");
+    for (uint32_t i = 0; i < count; ++i) {
+        trace.Free(trace.Allocate(size));
+    }
+    return trace;
+}
+
+// Spawn bursts of heroes (component blocks, ability state and name strings), then despawn
+// them in spawn order, for the given number of rounds
+inline AllocationTrace MakeSpawnBurstTrace(uint32_t rounds = 200, uint32_t heroesPerBurst = 10) {
+    // Per-hero allocation sizes modelled on a spawned hero: chunk-sized component data, four
+    // ability components, cooldown and status containers, and short strings
+    static const uint32_t s_heroSizes[] = {512, 128, 96, 96, 96, 96, 256, 64, 48, 32, 32, 24};
+
+    AllocationTrace trace("hero spawn burst");
+    std::vector<uint32_t> spawned;
+    for (uint32_t round = 0; round < rounds; ++round) {
+        spawned.clear();
+        for (uint32_t hero = 0; hero < heroesPerBurst; ++hero) {
+            for (uint32_t size : s_heroSizes) {
+                spawned.push_back(trace.Allocate(size));
+            }
+        }
+        for (uint32_t slot : spawned) {
+            trace.Free(slot);
+        }
+    }
+    return trace;
+}
+
+// Per-frame transient lists (query results, render queue entries, targeting candidates): many
+// small allocations, skewed toward the low end, all dropped at the end of each frame
+inline AllocationTrace MakeFrameTransientTrace(uint32_t frames = 300, uint32_t allocationsPerFrame = 1000, uint32_t seed = 1) {
+    AllocationTrace trace("frame transient");
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        for (uint32_t i = 0; i < allocationsPerFrame; ++i) {
+            float t = unit(rng);
+            trace.Allocate(16 + static_cast<uint32_t>(t * t * t * 1008.0f) / 16 * 16);
+        }
+        trace.EndFrame();
+    }
+    return trace;
+}
+
+// Steady-state match: a live set of about liveCount objects with mixed sizes and lifetimes,
+// freed in random order
+inline AllocationTrace MakeMatchMixTrace(uint32_t operations = 400000, uint32_t liveCount = 4096, uint32_t seed = 2) {
+    static const uint32_t s_sizes[] = {16, 24, 32, 48, 64, 64, 96, 128, 128, 256, 512, 1024};
+
+    AllocationTrace trace("match mix");
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> pickSize(0, sizeof(s_sizes) / sizeof(s_sizes[0]) - 1);
+    std::vector<uint32_t> live;
+    for (uint32_t i = 0; i < operations; ++i) {
+        if (live.empty() || (live.size() < liveCount && (rng() & 1))) {
+            live.push_back(trace.Allocate(s_sizes[pickSize(rng)]));
+        } else {
+            size_t victim = rng() % live.size();
+            trace.Free(live[victim]);
+            live[victim] = live.back();
+            live.pop_back();
+        }
+    }
+    return trace;
+}
+
+/**
+ * @brief An allocator under test, behind plain function pointers
+ *
+ * Capabilities say which traces it can replay: allocators without
+ * individual frees (linear, arena) need frees to come only from frame
+ * ends, stack allocators need LIFO traces, pools cap the block size, and
+ * only thread-safe allocators run the multi-threaded passes.
+ */
+struct BenchmarkTarget {
+    std::string name;
+
+    void* (*allocate)(void* context, size_t size, size_t alignment) = nullptr;
+    void (*free)(void* context, void* ptr, size_t size) = nullptr;
+
+    // Bulk release at frame ends (null frees each live block instead)
+    void (*reset)(void* context) = nullptr;
+
+    // Owns the allocator; context is the pointer passed to the functions above
+    std::shared_ptr<void> state;
+    void* context = nullptr;
+
+    bool individualFree = true;
+    bool lifoOnly = false;
+    bool threadSafe = false;
+
+    // Largest allocation served (0 = any)
+    size_t maxSize = 0;
+
+    // glibc (or platform) malloc
+    static BenchmarkTarget Malloc() {
+        BenchmarkTarget target;
+        target.name = "malloc";
+        target.allocate = [](void*, size_t size, size_t) { return std::malloc(size); };
+        target.free = [](void*, void* ptr, size_t) { std::free(ptr); };
+        target.threadSafe = true;
+        return target;
+    }
+
+    // Standard library size-class pools, as the arena-style general-purpose baseline
+    static BenchmarkTarget PmrPool() {
+        BenchmarkTarget target;
+        target.name = "pmr synchronized pool";
+        target.state = std::make_shared<std::pmr::synchronized_pool_resource>();
+        target.context = target.state.get();
+        target.allocate = [](void* context, size_t size, size_t alignment) {
+            return static_cast<std::pmr::memory_resource*>(context)->allocate(size, alignment);
+        };
+        target.free = [](void* context, void* ptr, size_t size) {
+            static_cast<std::pmr::memory_resource*>(context)->deallocate(ptr, size);
+        };
+        target.threadSafe = true;
+        return target;
+    }
+
+    // Any engine allocator through the Allocator interface
+    template<typename A>
+    static BenchmarkTarget FromAllocator(std::string name, std::shared_ptr<A> allocator) {
+        BenchmarkTarget target;
+        target.name = std::move(name);
+        target.state = allocator;
+        target.context = static_cast<Allocator*>(allocator.get());
+        target.allocate = [](void* context, size_t size, size_t alignment) {
+            return static_cast<Allocator*>(context)->Allocate(size, alignment);
+        };
+        target.free = [](void* context, void* ptr, size_t) { static_cast<Allocator*>(context)->Free(ptr); };
+        return target;
+    }
+
+    static BenchmarkTarget VirtualLinear(size_t reserveSize) {
+        BenchmarkTarget target = FromAllocator("VirtualLinearAllocator", std::make_shared<VirtualLinearAllocator>(reserveSize));
+        target.reset = [](void* context) { static_cast<VirtualLinearAllocator*>(static_cast<Allocator*>(context))->Reset(); };
+        target.individualFree = false;
+        return target;
+    }
+
+    static BenchmarkTarget VirtualStack(size_t reserveSize) {
+        BenchmarkTarget target = FromAllocator("VirtualStackAllocator", std::make_shared<VirtualStackAllocator>(reserveSize));
+        target.reset = [](void* context) { static_cast<VirtualStackAllocator*>(static_cast<Allocator*>(context))->Reset(); };
+        target.lifoOnly = true;
+        return target;
+    }
+
+    static BenchmarkTarget ConcurrentPool(size_t blockSize, size_t blockCount) {
+        BenchmarkTarget target = FromAllocator("ConcurrentPoolAllocator",
+                                               std::make_shared<ConcurrentPoolAllocator>(blockSize, blockCount));
+        target.maxSize = blockSize;
+        target.threadSafe = true;
+        return target;
+    }
+
+    static BenchmarkTarget Slab() {
+        BenchmarkTarget target = FromAllocator("SlabAllocator", std::make_shared<SlabAllocator>());
+        target.threadSafe = true;
+        return target;
+    }
+
+    static BenchmarkTarget Arena(size_t initialSize) {
+        BenchmarkTarget target = FromAllocator("ArenaAllocator", std::make_shared<ArenaAllocator>(initialSize));
+        target.reset = [](void* context) { static_cast<ArenaAllocator*>(static_cast<Allocator*>(context))->Release(); };
+        target.individualFree = false;
+        target.threadSafe = true;
+        return target;
+    }
+};
+
+/**
+ * @brief Outcome of replaying one trace against one target at one thread count
+ */
+struct AllocatorBenchmarkResult {
+    std::string target;
+    std::string trace;
+    uint32_t threads;
+
+    // Why the combination was not run (empty if it was)
+    std::string skipReason;
+
+    // Allocate and free operations per pass, over all threads
+    uint64_t operations;
+    uint64_t failedAllocations;
+
+    // Best pass over all threads
+    double operationsPerSecond;
+
+    // Per-operation latency of allocate and free calls, in nanoseconds
+    double p50Ns;
+    double p90Ns;
+    double p99Ns;
+    double p999Ns;
+    double maxNs;
+};
+
+/**
+ * @brief Settings of an AllocatorBenchmark run
+ */
+struct AllocatorBenchmarkOptions {
+    // Timed throughput passes per combination
+    uint32_t passes = 3;
+
+    // Thread counts to run (single-threaded-only targets are skipped above 1)
+    std::vector<uint32_t> threadCounts = {1, 4};
+};
+
+/**
+ * @brief Replays allocation traces against allocators and reports throughput and latency
+ *
+ * Each combination runs one warm-up pass, then the configured number of
+ * untimed-per-operation passes (the fastest gives throughput), then one
+ * pass that times every allocate and free call for the latency
+ * percentiles; the clock reads inflate those by a few tens of nanoseconds
+ * for every target alike. Multi-threaded passes replay the whole trace on
+ * every thread at once against the shared allocator. Run it from a tool or
+ * debug command in an optimized build, not inside a live match.
+ */
+class AllocatorBenchmark {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct LiveBlock {
+        void* ptr;
+        size_t size;
+    };
+
+    AllocatorBenchmarkOptions m_options;
+    std::vector<BenchmarkTarget> m_targets;
+    std::vector<AllocationTrace> m_traces;
+
+    static std::string CheckCompatible(const BenchmarkTarget& target, const AllocationTrace& trace, uint32_t threads) {
+        if (threads > 1 && !target.threadSafe) {
+            return "not thread-safe";
+        }
+        if (threads > 1 && trace.HasFrames() && target.reset) {
+            return "bulk reset is not per-thread";
+        }
+        if (trace.HasFrees() && !target.individualFree) {
+            return "no individual free";
+        }
+        if (!trace.IsLifo() && target.lifoOnly) {
+            return "trace is not LIFO";
+        }
+        if (target.maxSize != 0 && trace.GetMaxSize() > target.maxSize) {
+            return "block size too small";
+        }
+        return std::string();
+    }
+
+    // Replay a trace once on the calling thread; records per-operation latencies if latencies is set
+    static uint64_t Replay(const BenchmarkTarget& target, const AllocationTrace& trace, std::vector<LiveBlock>& slots,
+                           std::vector<uint32_t>* latencies) {
+        uint64_t failures = 0;
+        for (const AllocationTrace::Op& op : trace.GetOps()) {
+            switch (op.type) {
+                case AllocationTrace::OpType::Allocate: {
+                    Clock::time_point start = latencies ? Clock::now() : Clock::time_point();
+                    void* ptr = target.allocate(target.context, op.size, alignof(std::max_align_t));
+                    if (latencies) {
+                        latencies->push_back(ElapsedNs(start));
+                    }
+                    failures += ptr ? 0 : 1;
+                    slots[op.slot] = LiveBlock{ptr, op.size};
+                    break;
+                }
+                case AllocationTrace::OpType::Free: {
+                    void* ptr = slots[op.slot].ptr;
+                    Clock::time_point start = latencies ? Clock::now() : Clock::time_point();
+                    if (ptr) {
+                        target.free(target.context, ptr, op.size);
+                    }
+                    if (latencies) {
+                        latencies->push_back(ElapsedNs(start));
+                    }
+                    slots[op.slot].ptr = nullptr;
+                    break;
+                }
+                case AllocationTrace::OpType::EndFrame:
+                    ReleaseLive(target, slots);
+                    break;
+            }
+        }
+        ReleaseLive(target, slots);
+        return failures;
+    }
+
+    static uint32_t ElapsedNs(Clock::time_point start) {
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    // Release everything still live: a bulk reset if the target has one, otherwise a free per block
+    static void ReleaseLive(const BenchmarkTarget& target, std::vector<LiveBlock>& slots) {
+        if (target.reset) {
+            target.reset(target.context);
+            for (LiveBlock& block : slots) {
+                block.ptr = nullptr;
+            }
+            return;
+        }
+        for (LiveBlock& block : slots) {
+            if (block.ptr) {
+                target.free(target.context, block.ptr, block.size);
+                block.ptr = nullptr;
+            }
+        }
+    }
+
+    // Run a pass on threads threads; returns the wall time in seconds
+    static double RunPass(const BenchmarkTarget& target, const AllocationTrace& trace, uint32_t threads,
+                          std::vector<std::vector<uint32_t>>* latencies, uint64_t* failures) {
+        std::vector<std::vector<LiveBlock>> slots(threads, std::vector<LiveBlock>(trace.GetSlotCount(), LiveBlock{nullptr, 0}));
+        std::vector<uint64_t> threadFailures(threads, 0);
+        std::atomic<uint32_t> ready{0};
+        std::atomic<bool> go{false};
+
+        auto body = [&](uint32_t index) {
+            ready.fetch_add(1, std::memory_order_acq_rel);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            threadFailures[index] = Replay(target, trace, slots[index], latencies ? &(*latencies)[index] : nullptr);
+        };
+
+        std::vector<std::thread> workers;
+        for (uint32_t i = 1; i < threads; ++i) {
+            workers.emplace_back(body, i);
+        }
+        while (ready.load(std::memory_order_acquire) < threads - 1) {
+            std::this_thread::yield();
+        }
+        Clock::time_point start = Clock::now();
+        go.store(true, std::memory_order_release);
+        body(0);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        if (failures) {
+            *failures = 0;
+            for (uint64_t count : threadFailures) {
+                *failures += count;
+            }
+        }
+        return seconds;
+    }
+
+    static double Percentile(const std::vector<uint32_t>& sorted, double percentile) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        size_t index = static_cast<size_t>(percentile / 100.0 * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+public:
+    explicit AllocatorBenchmark(const AllocatorBenchmarkOptions& options = AllocatorBenchmarkOptions()) : m_options(options) {}
+
+    // Add an allocator to compare
+    void AddTarget(BenchmarkTarget target) { m_targets.push_back(std::move(target)); }
+
+    // Add a workload to replay
+    void AddTrace(AllocationTrace trace) { m_traces.push_back(std::move(trace)); }
+
+    // The default suite: malloc and the standard pool resource as baselines against the engine
+    // allocators that are defined in the headers, over churn, hero spawn bursts, frame transients
+    // and a steady-state match mix
+    static AllocatorBenchmark CreateDefault(const AllocatorBenchmarkOptions& options = AllocatorBenchmarkOptions()) {
+        AllocatorBenchmark benchmark(options);
+        benchmark.AddTarget(BenchmarkTarget::Malloc());
+        benchmark.AddTarget(BenchmarkTarget::PmrPool());
+        benchmark.AddTarget(BenchmarkTarget::VirtualLinear(64 * 1024 * 1024));
+        benchmark.AddTarget(BenchmarkTarget::VirtualStack(64 * 1024 * 1024));
+        benchmark.AddTarget(BenchmarkTarget::ConcurrentPool(1024, 64 * 1024));
+        benchmark.AddTarget(BenchmarkTarget::Slab());
+        benchmark.AddTarget(BenchmarkTarget::Arena(1024 * 1024));
+        benchmark.AddTrace(MakeChurnTrace());
+        benchmark.AddTrace(MakeSpawnBurstTrace());
+        benchmark.AddTrace(MakeFrameTransientTrace());
+        benchmark.AddTrace(MakeMatchMixTrace());
+        return benchmark;
+    }
+
+    // Run every trace against every target at every thread count
+    std::vector<AllocatorBenchmarkResult> Run() const {
+        std::vector<AllocatorBenchmarkResult> results;
+        for (const AllocationTrace& trace : m_traces) {
+            for (uint32_t threads : m_options.threadCounts) {
+                for (const BenchmarkTarget& target : m_targets) {
+                    results.push_back(Run(target, trace, threads));
+                }
+            }
+        }
+        return results;
+    }
+
+    // Run one combination
+    AllocatorBenchmarkResult Run(const BenchmarkTarget& target, const AllocationTrace& trace, uint32_t threads) const {
+        threads = std::max<uint32_t>(threads, 1);
+        AllocatorBenchmarkResult result = {};
+        result.target = target.name;
+        result.trace = trace.GetName();
+        result.threads = threads;
+        result.skipReason = CheckCompatible(target, trace, threads);
+        if (!result.skipReason.empty()) {
+            return result;
+        }
+
+        uint64_t operationsPerThread = 0;
+        for (const AllocationTrace::Op& op : trace.GetOps()) {
+            operationsPerThread += op.type == AllocationTrace::OpType::EndFrame ? 0 : 1;
+        }
+        result.operations = operationsPerThread * threads;
+
+        RunPass(target, trace, threads, nullptr, nullptr);
+        double best = 0.0;
+        for (uint32_t pass = 0; pass < std::max<uint32_t>(m_options.passes, 1); ++pass) {
+            double seconds = RunPass(target, trace, threads, nullptr, &result.failedAllocations);
+            best = pass == 0 ? seconds : std::min(best, seconds);
+        }
+        result.operationsPerSecond = best > 0.0 ? result.operations / best : 0.0;
+
+        std::vector<std::vector<uint32_t>> latencies(threads);
+        for (std::vector<uint32_t>& samples : latencies) {
+            samples.reserve(operationsPerThread);
+        }
+        RunPass(target, trace, threads, &latencies, nullptr);
+        std::vector<uint32_t> merged;
+        merged.reserve(result.operations);
+        for (const std::vector<uint32_t>& samples : latencies) {
+            merged.insert(merged.end(), samples.begin(), samples.end());
+        }
+        std::sort(merged.begin(), merged.end());
+        result.p50Ns = Percentile(merged, 50.0);
+        result.p90Ns = Percentile(merged, 90.0);
+        result.p99Ns = Percentile(merged, 99.0);
+        result.p999Ns = Percentile(merged, 99.9);
+        result.maxNs = merged.empty() ? 0.0 : merged.back();
+        return result;
+    }
+
+    // Format results as a table, one line per combination
+    static std::string Format(const std::vector<AllocatorBenchmarkResult>& results) {
+        std::string text;
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-20s %-26s %3s %12s %8s %8s %8s %8s %10s\n", "trace", "allocator", "thr",
+                      "Mops/s", "p50 ns", "p90 ns", "p99 ns", "p99.9 ns", "max ns");
+        text += line;
+        for (const AllocatorBenchmarkResult& result : results) {
+            if (!result.skipReason.empty()) {
+                std::snprintf(line, sizeof(line), "%-20s %-26s %3u   skipped: %s\n", result.trace.c_str(), result.target.c_str(),
+                              result.threads, result.skipReason.c_str());
+            } else {
+                std::snprintf(line, sizeof(line), "%-20s %-26s %3u %12.2f %8.0f %8.0f %8.0f %8.0f %10.0f%s\n",
+                              result.trace.c_str(), result.target.c_str(), result.threads, result.operationsPerSecond / 1e6,
+                              result.p50Ns, result.p90Ns, result.p99Ns, result.p999Ns, result.maxNs,
+                              result.failedAllocations ? "  (allocations failed)" : "");
+            }
+            text += line;
+        }
+        return text;
+    }
+};
+
+} // namespace CHULUBME
@@ -0,0 +1,46 @@
+#pragma once
+
+/**
+ * @brief AVX2 kernels that are chosen at run time on x86 builds that do not target AVX2
+ *
+ * GCC and Clang compile a function marked CHULUBME_TARGET_AVX2 with AVX2
+ * enabled whatever -march the engine is built with, so a default x86-64
+ * build still carries the AVX2 kernels and HasAvx2() picks them on CPUs
+ * that support them. Builds that already target AVX2 (-mavx2, -march=haswell,
+ * /arch:AVX2) use them unconditionally. MSVC has no per-function target, so
+ * there the kernels exist only under /arch:AVX2. CHULUBME_HAS_AVX2_KERNELS
+ * is 1 wherever they are compiled.
+ */
+#if defined(__AVX2__)
+#define CHULUBME_HAS_AVX2_KERNELS 1
+#define CHULUBME_TARGET_AVX2
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CHULUBME_HAS_AVX2_KERNELS 1
+#define CHULUBME_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CHULUBME_HAS_AVX2_KERNELS 0
+#define CHULUBME_TARGET_AVX2
+#endif
+
+#if CHULUBME_HAS_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace CHULUBME {
+
+// Check whether the CPU runs the AVX2 kernels (detected once per process)
+inline bool HasAvx2() {
+#if defined(__AVX2__)
+    return true;
+#elif CHULUBME_HAS_AVX2_KERNELS
+    static const bool s_avx2 = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return s_avx2;
+#else
+    return false;
+#endif
+}
+
+} // namespace CHULUBME
@@ -0,0 +1,1580 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "memory.h"
+#include "thread_slot.h"
+
+namespace CHULUBME {
+
+/**
+ * @brief Generational entity handle
+ *
+ * The index selects a slot in the entity manager's slot table and the
+ * generation must match the slot's current generation for the handle to be
+ * alive. Destroying an entity bumps its slot's generation, so stale handles
+ * are rejected with a single compare. Live generations are never 0.
+ */
+struct Entity {
+    uint32_t index;
+    uint32_t generation;
+
+    constexpr Entity() : index(0), generation(0) {}
+    constexpr Entity(uint32_t entityIndex, uint32_t entityGeneration) : index(entityIndex), generation(entityGeneration) {}
+
+    // Check if the handle was ever issued (says nothing about whether it is still alive)
+    constexpr bool IsValid() const { return generation != 0; }
+
+    // Pack the handle into a single 64-bit value
+    constexpr uint64_t ToId() const { return (static_cast<uint64_t>(generation) << 32) | index; }
+
+    constexpr bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+    constexpr bool operator!=(const Entity& other) const { return !(*this == other); }
+    constexpr bool operator<(const Entity& other) const { return ToId() < other.ToId(); }
+};
+
+// Handle that never refers to a live entity
+constexpr Entity NULL_ENTITY{};
+
+// Dense component type identifier, assigned the first time a type is used
+using ComponentTypeId = uint32_t;
+
+// Maximum number of distinct component types
+constexpr ComponentTypeId MAX_COMPONENT_TYPES = 64;
+
+// One bit per component type
+using ComponentMask = uint64_t;
+
+// Size of one archetype chunk
+constexpr size_t ARCHETYPE_CHUNK_SIZE = 16 * 1024;
+
+// Alignment of archetype chunks
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Change tick; every system run and every write outside a system gets a newer tick
+using ChangeTick = uint64_t;
+
+static_assert(std::atomic<ChangeTick>::is_always_lock_free && sizeof(std::atomic<ChangeTick>) == sizeof(ChangeTick),
+              "Chunk headers store change ticks as lock-free atomics");
+
+class EntityManager;
+class TimingWheel;
+template<typename... Ts>
+class ComponentView;
+
+/**
+ * @brief Base class for all components
+ *
+ * Components are stored by value inside archetype chunks, so a pointer to a
+ * component is only valid until the owning entity changes its component set
+ * or another entity of the same archetype is destroyed.
+ */
+class Component {
+public:
+    virtual ~Component() = default;
+
+    // Initialize the component (called once it is constructed in its chunk)
+    virtual void Initialize() {}
+
+    // Finalize the component (called before it is destroyed)
+    virtual void Finalize() {}
+};
+
+/**
+ * @brief Type-erased operations for a component type
+ */
+struct ComponentTypeInfo {
+    size_t size;
+    size_t alignment;
+
+    // Move-construct the component at src into the uninitialized memory at dst
+    void (*moveConstruct)(void* dst, void* src);
+
+    // Run the destructor of the component at ptr
+    void (*destroy)(void* ptr);
+
+    // Get the Component base of the component at ptr
+    Component* (*toComponent)(void* ptr);
+
+    // Whether EntityManager::Teardown may drop the component without running its destructor
+    bool skipDestructorOnTeardown;
+};
+
+/**
+ * @brief Whether a component's destructor can be skipped when a whole world is torn down
+ *
+ * Opt-in and false by default: components derive from the polymorphic
+ * Component, so none is ever trivially destructible and the compiler cannot
+ * tell. Specialise to std::true_type next to a component that holds only
+ * plain data, or whose destructor does nothing but release memory that
+ * comes from the world's arena (e.g. pmr containers on
+ * World::GetArenaResource), since the arena is released wholesale anyway.
+ */
+template<typename T>
+struct SkipDestructorOnTeardown : std::false_type {};
+
+/**
+ * @brief Assigns dense ids to component types and records how to move and destroy them
+ */
+class ComponentRegistry {
+private:
+    static std::atomic<ComponentTypeId>& Counter() {
+        static std::atomic<ComponentTypeId> s_counter{0};
+        return s_counter;
+    }
+
+    static ComponentTypeInfo* Infos() {
+        static ComponentTypeInfo s_infos[MAX_COMPONENT_TYPES] = {};
+        return s_infos;
+    }
+
+    template<typename T>
+    static ComponentTypeId Register() {
+        static_assert(std::is_base_of<Component, T>::value, "Components must derive from Component");
+        static_assert(alignof(T) <= CACHE_LINE_SIZE, "Component alignment exceeds chunk alignment");
+
+        ComponentTypeId id = Counter().fetch_add(1, std::memory_order_relaxed);
+        assert(id < MAX_COMPONENT_TYPES && "Too many component types");
+        Infos()[id] = ComponentTypeInfo{
+            sizeof(T),
+            alignof(T),
+            [](void* dst, void* src) { new (dst) T(std::move(*static_cast<T*>(src))); },
+            [](void* ptr) { static_cast<T*>(ptr)->~T(); },
+            [](void* ptr) -> Component* { return static_cast<T*>(ptr); },
+            SkipDestructorOnTeardown<T>::value
+        };
+        return id;
+    }
+
+    template<typename T>
+    static ComponentTypeId Id() {
+        static const ComponentTypeId s_id = Register<T>();
+        return s_id;
+    }
+
+public:
+    // Get the id of a component type
+    template<typename T>
+    static ComponentTypeId TypeId() { return Id<std::remove_cv_t<T>>(); }
+
+    // Get the mask containing the given component types (computed once per type list)
+    template<typename... Ts>
+    static ComponentMask Mask() {
+        static const ComponentMask s_mask = (ComponentMask{0} | ... | (ComponentMask{1} << TypeId<Ts>()));
+        return s_mask;
+    }
+
+    // Get the type information for a registered id
+    static const ComponentTypeInfo& Info(ComponentTypeId id) { return Infos()[id]; }
+};
+
+/**
+ * @brief Recycles the archetype chunk memory of one entity manager
+ *
+ * Chunks come from a chunk allocator (typically a world's arena) or the
+ * global heap. Emptied chunks go on a free list and are reused before any
+ * new chunk is allocated, so entity churn across chunk boundaries does not
+ * grow the allocator. Chunk memory is never handed back to the allocator
+ * one block at a time, since an arena cannot release single blocks; it is
+ * released wholesale with the allocator. Only used during structural
+ * changes, which are single-threaded.
+ */
+class ChunkPool {
+private:
+    // Source of chunk memory, or null for the global heap
+    Allocator* m_allocator;
+
+    std::vector<uint8_t*> m_freeChunks;
+
+public:
+    explicit ChunkPool(Allocator* allocator = nullptr) : m_allocator(allocator) {}
+
+    ~ChunkPool() { Release(); }
+
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool& operator=(const ChunkPool&) = delete;
+
+    // Get a chunk, reusing a free one when there is any
+    uint8_t* Acquire() {
+        if (!m_freeChunks.empty()) {
+            uint8_t* chunk = m_freeChunks.back();
+            m_freeChunks.pop_back();
+            return chunk;
+        }
+        if (m_allocator) {
+            void* memory = m_allocator->Allocate(ARCHETYPE_CHUNK_SIZE, CACHE_LINE_SIZE);
+            if (!memory) {
+                throw std::bad_alloc();
+            }
+            return static_cast<uint8_t*>(memory);
+        }
+        return static_cast<uint8_t*>(::operator new(ARCHETYPE_CHUNK_SIZE, std::align_val_t(CACHE_LINE_SIZE)));
+    }
+
+    // Put an emptied chunk on the free list
+    void Recycle(uint8_t* chunk) { m_freeChunks.push_back(chunk); }
+
+    // Empty the free list: heap chunks are deleted, allocator chunks are only forgotten (call before
+    // the allocator is released wholesale, e.g. World::Teardown releasing its arena)
+    void Release() {
+        if (!m_allocator) {
+            for (uint8_t* chunk : m_freeChunks) {
+                ::operator delete(chunk, std::align_val_t(CACHE_LINE_SIZE));
+            }
+        }
+        m_freeChunks.clear();
+    }
+
+    // Get the number of chunks waiting for reuse
+    size_t GetFreeCount() const { return m_freeChunks.size(); }
+};
+
+/**
+ * @brief A 16 KB block holding up to GetChunkCapacity() entities of one archetype
+ *
+ * Memory layout is a header with one change tick per column, then one array
+ * of entity ids, then one array per component type (structure of arrays).
+ */
+struct ArchetypeChunk {
+    uint8_t* data;
+    uint32_t count;
+};
+
+/**
+ * @brief Storage for all entities that share the same set of component types
+ *
+ * Rows are kept dense: removing a row moves the last row of the last chunk
+ * into the hole, so every chunk except the last one is always full.
+ */
+class Archetype {
+private:
+    ComponentMask m_mask;
+
+    // Component types in ascending id order, one column each
+    std::vector<ComponentTypeId> m_types;
+
+    // Byte offset of each column inside a chunk
+    std::vector<uint32_t> m_columnOffsets;
+
+    // Byte offset of the entity array inside a chunk (after the column tick header)
+    uint32_t m_entitiesOffset;
+
+    // Column index for each component type id, or -1
+    int8_t m_columnIndex[MAX_COMPONENT_TYPES];
+
+    // Entities per chunk
+    uint32_t m_chunkCapacity;
+
+    std::vector<ArchetypeChunk> m_chunks;
+
+    // Empty chunk kept around so an entity bouncing across a chunk boundary does not reallocate
+    uint8_t* m_spareChunk;
+
+    // Cached transitions to the archetype with one component type added or removed
+    Archetype* m_addEdges[MAX_COMPONENT_TYPES];
+    Archetype* m_removeEdges[MAX_COMPONENT_TYPES];
+
+    // Owner's chunk pool that chunk memory comes from and returns to
+    ChunkPool* m_chunkPool;
+
+    uint8_t* AllocateChunkMemory() { return m_chunkPool->Acquire(); }
+
+    void FreeChunkMemory(uint8_t* memory) { m_chunkPool->Recycle(memory); }
+
+    void* GetComponentAt(const ArchetypeChunk& chunk, size_t column, uint32_t row) const {
+        return chunk.data + m_columnOffsets[column] + row * ComponentRegistry::Info(m_types[column]).size;
+    }
+
+public:
+    Archetype(ComponentMask mask, ChunkPool* chunkPool)
+        : m_mask(mask), m_entitiesOffset(0), m_chunkCapacity(0), m_spareChunk(nullptr), m_chunkPool(chunkPool) {
+        for (ComponentTypeId id = 0; id < MAX_COMPONENT_TYPES; ++id) {
+            m_columnIndex[id] = -1;
+            m_addEdges[id] = nullptr;
+            m_removeEdges[id] = nullptr;
+            if (mask & (ComponentMask{1} << id)) {
+                m_columnIndex[id] = static_cast<int8_t>(m_types.size());
+                m_types.push_back(id);
+            }
+        }
+
+        m_entitiesOffset = static_cast<uint32_t>((m_types.size() * sizeof(ChangeTick) + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1));
+
+        // Size the chunk for the worst-case alignment padding between columns
+        size_t rowSize = sizeof(Entity);
+        size_t padding = 0;
+        for (ComponentTypeId id : m_types) {
+            rowSize += ComponentRegistry::Info(id).size;
+            padding += ComponentRegistry::Info(id).alignment;
+        }
+        m_chunkCapacity = static_cast<uint32_t>((ARCHETYPE_CHUNK_SIZE - m_entitiesOffset - padding) / rowSize);
+        assert(m_chunkCapacity > 0 && "Component set does not fit in a chunk");
+
+        size_t offset = m_entitiesOffset + m_chunkCapacity * sizeof(Entity);
+        for (ComponentTypeId id : m_types) {
+            const ComponentTypeInfo& info = ComponentRegistry::Info(id);
+            offset = (offset + info.alignment - 1) & ~(info.alignment - 1);
+            m_columnOffsets.push_back(static_cast<uint32_t>(offset));
+            offset += m_chunkCapacity * info.size;
+        }
+    }
+
+    ~Archetype() { Clear(false); }
+
+    // Destroy every row and release all chunks; with skipTrivial, columns whose type allows it
+    // (SkipDestructorOnTeardown) are dropped without running destructors
+    void Clear(bool skipTrivial) {
+        for (size_t column = 0; column < m_types.size(); ++column) {
+            const ComponentTypeInfo& info = ComponentRegistry::Info(m_types[column]);
+            if (skipTrivial && info.skipDestructorOnTeardown) {
+                continue;
+            }
+            for (ArchetypeChunk& chunk : m_chunks) {
+                for (uint32_t row = 0; row < chunk.count; ++row) {
+                    info.destroy(GetComponentAt(chunk, column, row));
+                }
+            }
+        }
+        for (ArchetypeChunk& chunk : m_chunks) {
+            FreeChunkMemory(chunk.data);
+        }
+        m_chunks.clear();
+        if (m_spareChunk) {
+            FreeChunkMemory(m_spareChunk);
+            m_spareChunk = nullptr;
+        }
+    }
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    // Get the component mask
+    ComponentMask GetMask() const { return m_mask; }
+
+    // Get the component types stored in this archetype
+    const std::vector<ComponentTypeId>& GetTypes() const { return m_types; }
+
+    // Check if this archetype stores a component type
+    bool HasType(ComponentTypeId id) const { return m_columnIndex[id] >= 0; }
+
+    // Get the number of entities a chunk can hold
+    uint32_t GetChunkCapacity() const { return m_chunkCapacity; }
+
+    // Get the number of chunks
+    size_t GetChunkCount() const { return m_chunks.size(); }
+
+    // Get a chunk
+    const ArchetypeChunk& GetChunk(size_t index) const { return m_chunks[index]; }
+
+    // Get the number of entities in this archetype
+    size_t GetEntityCount() const {
+        return m_chunks.empty() ? 0 : (m_chunks.size() - 1) * m_chunkCapacity + m_chunks.back().count;
+    }
+
+    // Get the entity array of a chunk
+    Entity* GetEntities(const ArchetypeChunk& chunk) const { return reinterpret_cast<Entity*>(chunk.data + m_entitiesOffset); }
+
+    // Get the per-column change ticks of a chunk (atomic, since parallel jobs may write the same chunk)
+    std::atomic<ChangeTick>* GetChangeTicks(const ArchetypeChunk& chunk) const {
+        return reinterpret_cast<std::atomic<ChangeTick>*>(chunk.data);
+    }
+
+    // Get the tick of the last write to a component type's column in a chunk
+    ChangeTick GetChangeTick(const ArchetypeChunk& chunk, ComponentTypeId id) const {
+        return GetChangeTicks(chunk)[m_columnIndex[id]].load(std::memory_order_relaxed);
+    }
+
+    // Record a write to a component type's column in a chunk; safe from concurrent jobs (atomic max)
+    void MarkChanged(const ArchetypeChunk& chunk, ComponentTypeId id, ChangeTick tick) const {
+        std::atomic<ChangeTick>& columnTick = GetChangeTicks(chunk)[m_columnIndex[id]];
+        ChangeTick current = columnTick.load(std::memory_order_relaxed);
+        while (current < tick && !columnTick.compare_exchange_weak(current, tick, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Get the column of a component type in a chunk
+    template<typename T>
+    T* GetColumn(const ArchetypeChunk& chunk) const {
+        return reinterpret_cast<T*>(chunk.data + m_columnOffsets[m_columnIndex[ComponentRegistry::TypeId<T>()]]);
+    }
+
+    // Get a single component of a row
+    void* GetComponent(uint32_t chunkIndex, uint32_t row, ComponentTypeId id) const {
+        return GetComponentAt(m_chunks[chunkIndex], m_columnIndex[id], row);
+    }
+
+    // Get the cached archetype reached by adding a component type
+    Archetype* GetAddEdge(ComponentTypeId id) const { return m_addEdges[id]; }
+
+    // Cache the archetype reached by adding a component type
+    void SetAddEdge(ComponentTypeId id, Archetype* archetype) { m_addEdges[id] = archetype; }
+
+    // Get the cached archetype reached by removing a component type
+    Archetype* GetRemoveEdge(ComponentTypeId id) const { return m_removeEdges[id]; }
+
+    // Cache the archetype reached by removing a component type
+    void SetRemoveEdge(ComponentTypeId id, Archetype* archetype) { m_removeEdges[id] = archetype; }
+
+    // Append a row for an entity; the component memory of the row is left uninitialized.
+    // Every column of the receiving chunk is stamped with tick.
+    void AllocateRow(Entity entity, ChangeTick tick, uint32_t& chunkIndex, uint32_t& row) {
+        if (m_chunks.empty() || m_chunks.back().count == m_chunkCapacity) {
+            uint8_t* memory = m_spareChunk ? m_spareChunk : AllocateChunkMemory();
+            m_spareChunk = nullptr;
+            m_chunks.push_back(ArchetypeChunk{memory, 0});
+            for (size_t column = 0; column < m_types.size(); ++column) {
+                new (&GetChangeTicks(m_chunks.back())[column]) std::atomic<ChangeTick>(tick);
+            }
+        }
+        ArchetypeChunk& chunk = m_chunks.back();
+        chunkIndex = static_cast<uint32_t>(m_chunks.size() - 1);
+        row = chunk.count++;
+        GetEntities(chunk)[row] = entity;
+        for (size_t column = 0; column < m_types.size(); ++column) {
+            GetChangeTicks(chunk)[column].store(tick, std::memory_order_relaxed);
+        }
+    }
+
+    // Move every component this archetype shares with the source row into a row of this archetype
+    void MoveSharedComponents(Archetype& source, uint32_t sourceChunk, uint32_t sourceRow, uint32_t chunkIndex, uint32_t row) {
+        for (size_t column = 0; column < m_types.size(); ++column) {
+            ComponentTypeId id = m_types[column];
+            if (source.HasType(id)) {
+                ComponentRegistry::Info(id).moveConstruct(GetComponentAt(m_chunks[chunkIndex], column, row),
+                                                          source.GetComponent(sourceChunk, sourceRow, id));
+            }
+        }
+    }
+
+    // Destroy the components of a row and fill the hole with the last row.
+    // Returns the entity that now occupies the row, or NULL_ENTITY if the removed row was the last one.
+    Entity RemoveRow(uint32_t chunkIndex, uint32_t row) {
+        ArchetypeChunk& chunk = m_chunks[chunkIndex];
+        ArchetypeChunk& last = m_chunks.back();
+        uint32_t lastRow = last.count - 1;
+        bool isLast = (&chunk == &last) && row == lastRow;
+
+        for (size_t column = 0; column < m_types.size(); ++column) {
+            const ComponentTypeInfo& info = ComponentRegistry::Info(m_types[column]);
+            void* hole = GetComponentAt(chunk, column, row);
+            info.destroy(hole);
+            if (!isLast) {
+                void* moved = GetComponentAt(last, column, lastRow);
+                info.moveConstruct(hole, moved);
+                info.destroy(moved);
+
+                // The moved row carries its chunk's pending changes with it
+                MarkChanged(chunk, m_types[column], GetChangeTicks(last)[column].load(std::memory_order_relaxed));
+            }
+        }
+
+        Entity movedEntity = NULL_ENTITY;
+        if (!isLast) {
+            movedEntity = GetEntities(last)[lastRow];
+            GetEntities(chunk)[row] = movedEntity;
+        }
+
+        if (--last.count == 0) {
+            if (m_spareChunk) {
+                FreeChunkMemory(m_spareChunk);
+            }
+            m_spareChunk = last.data;
+            m_chunks.pop_back();
+        }
+        return movedEntity;
+    }
+};
+
+/**
+ * @brief Base class for all systems
+ */
+class System {
+protected:
+    // Entity manager that owns this system
+    EntityManager* m_entityManager;
+
+    // Component types an entity needs to be added to this system (0 means no notifications)
+    ComponentMask m_signature;
+
+    // Component types this system reads and writes during Update/FixedUpdate
+    ComponentMask m_readMask;
+    ComponentMask m_writeMask;
+
+    // Whether the system declared its component access (undeclared systems run exclusively)
+    bool m_declaresAccess;
+
+    // Tick of the current run (stamps this system's writes) and of the previous run
+    ChangeTick m_runTick;
+    ChangeTick m_lastRunTick;
+
+    // Set the component types this system is interested in
+    template<typename... Ts>
+    void SetSignature() { m_signature = ComponentRegistry::Mask<Ts...>(); }
+
+    // Declare component types this system only reads
+    template<typename... Ts>
+    void Reads() {
+        m_readMask |= ComponentRegistry::Mask<Ts...>();
+        m_declaresAccess = true;
+    }
+
+    // Declare component types this system writes
+    template<typename... Ts>
+    void Writes() {
+        m_writeMask |= ComponentRegistry::Mask<Ts...>();
+        m_declaresAccess = true;
+    }
+
+public:
+    // Get a view whose writes are stamped with this run's tick and whose Changed<T> terms
+    // match writes made since this system's previous run (defined after EntityManager)
+    template<typename... Ts>
+    ComponentView<Ts...> Query() const;
+
+    explicit System(EntityManager* manager)
+        : m_entityManager(manager), m_signature(0), m_readMask(0), m_writeMask(0), m_declaresAccess(false),
+          m_runTick(0), m_lastRunTick(0) {}
+    virtual ~System() = default;
+
+    // Initialize the system
+    virtual void Initialize() {}
+
+    // Update the system
+    virtual void Update(float /*deltaTime*/) {}
+
+    // Fixed update at a consistent time step
+    virtual void FixedUpdate(float /*fixedTimeStep*/) {}
+
+    // Render the system
+    virtual void Render() {}
+
+    // Called when an entity gains the last component of this system's signature
+    virtual void OnEntityAdded(Entity /*entity*/) {}
+
+    // Called when an entity loses a component of this system's signature or is destroyed
+    virtual void OnEntityRemoved(Entity /*entity*/) {}
+
+    // Called by EntityManager::Teardown once every entity is gone; drop per-match state here
+    virtual void OnTeardown() {}
+
+    // Get the signature
+    ComponentMask GetSignature() const { return m_signature; }
+
+    // Get the component types this system reads
+    ComponentMask GetReadMask() const { return m_readMask; }
+
+    // Get the component types this system writes
+    ComponentMask GetWriteMask() const { return m_writeMask; }
+
+    // Check if the system declared its component access
+    bool DeclaresAccess() const { return m_declaresAccess; }
+
+    // Start a run with a fresh tick from the entity manager
+    void BeginRun(ChangeTick tick) { m_runTick = tick; }
+
+    // Finish a run; the next run's Changed<T> terms see writes newer than this one's tick
+    void EndRun() {
+        m_lastRunTick = m_runTick;
+        m_runTick = 0;
+    }
+
+    // Get the tick of the previous run (0 if the system never ran)
+    ChangeTick GetLastRunTick() const { return m_lastRunTick; }
+
+    // Check if two systems may not run at the same time
+    bool ConflictsWith(const System& other) const {
+        if (!m_declaresAccess || !other.m_declaresAccess) {
+            return true;
+        }
+        return (m_writeMask & (other.m_readMask | other.m_writeMask)) != 0 ||
+               (other.m_writeMask & m_readMask) != 0;
+    }
+
+    // Get the entity manager
+    EntityManager* GetEntityManager() const { return m_entityManager; }
+};
+
+/**
+ * @brief Query filter: only visit chunks where T was written since the view's changedSince tick
+ *
+ * Used in a view's component list in place of T, e.g.
+ * View<Changed<const TransformComponent>, MeshRendererComponent>(); the row still yields T&.
+ * Change tracking is per chunk and column, so every entity in a changed chunk is visited.
+ */
+template<typename T>
+struct Changed {};
+
+// Maps a view term (T or Changed<T>) to its component type
+template<typename T>
+struct QueryTerm {
+    using Type = T;
+    static constexpr bool changedFilter = false;
+};
+
+template<typename T>
+struct QueryTerm<Changed<T>> {
+    using Type = T;
+    static constexpr bool changedFilter = true;
+};
+
+/**
+ * @brief Range over every entity that has all of the given components
+ *
+ * Created by EntityManager::View or System::Query. Iterating yields
+ * std::tuple<Entity, Ts&...>, so it can be used with range-for and structured
+ * bindings:
+ *
+ *     for (auto [entity, hero, transform] : manager->View<HeroComponent, const TransformComponent>()) { ... }
+ *
+ * Each() walks the same rows chunk by chunk and is the faster choice for hot
+ * loops. Visiting a chunk through a non-const term stamps that column with the
+ * view's write tick, which is what Changed<T> filters on. A view must not
+ * outlive a structural change to the entity manager.
+ */
+template<typename... Ts>
+class ComponentView {
+public:
+    using Value = std::tuple<Entity, typename QueryTerm<Ts>::Type&...>;
+
+    // Chunk filter and write stamping shared by the view and its iterators
+    struct Filter {
+        ChangeTick changedSince;
+        ChangeTick writeTick;
+        ComponentTypeId changedTypes[sizeof...(Ts) + 1];
+        size_t changedCount;
+        ComponentTypeId writtenTypes[sizeof...(Ts) + 1];
+        size_t writtenCount;
+
+        // Check if a chunk passes every Changed<T> term; if so, stamp the columns written through this view
+        bool Accept(const Archetype& archetype, const ArchetypeChunk& chunk) const {
+            for (size_t i = 0; i < changedCount; ++i) {
+                if (archetype.GetChangeTick(chunk, changedTypes[i]) <= changedSince) {
+                    return false;
+                }
+            }
+            for (size_t i = 0; i < writtenCount; ++i) {
+                archetype.MarkChanged(chunk, writtenTypes[i], writeTick);
+            }
+            return true;
+        }
+    };
+
+private:
+    using Columns = std::tuple<typename QueryTerm<Ts>::Type*...>;
+
+    // Matching archetypes, owned by the entity manager's query cache
+    const std::vector<Archetype*>* m_archetypes;
+
+    Filter m_filter;
+
+    static Columns GetColumns(const Archetype& archetype, const ArchetypeChunk& chunk) {
+        return Columns(archetype.template GetColumn<typename QueryTerm<Ts>::Type>(chunk)...);
+    }
+
+    template<typename Fn, size_t... Is>
+    static void EachRow(Fn& fn, const Entity* entities, uint32_t count, const Columns& columns, std::index_sequence<Is...>) {
+        for (uint32_t row = 0; row < count; ++row) {
+            fn(entities[row], std::get<Is>(columns)[row]...);
+        }
+    }
+
+public:
+    class Iterator {
+    private:
+        const std::vector<Archetype*>* m_archetypes;
+        const Filter* m_filter;
+        size_t m_archetype;
+        size_t m_chunk;
+        uint32_t m_row;
+        uint32_t m_count;
+        const Entity* m_entities;
+        Columns m_columns;
+
+        // Point at the first row of the next accepted chunk at or after (m_archetype, m_chunk); chunks are never empty
+        void LoadChunk() {
+            m_row = 0;
+            while (m_archetype < m_archetypes->size()) {
+                const Archetype* archetype = (*m_archetypes)[m_archetype];
+                if (m_chunk >= archetype->GetChunkCount()) {
+                    ++m_archetype;
+                    m_chunk = 0;
+                    continue;
+                }
+                const ArchetypeChunk& chunk = archetype->GetChunk(m_chunk);
+                if (!m_filter->Accept(*archetype, chunk)) {
+                    ++m_chunk;
+                    continue;
+                }
+                m_count = chunk.count;
+                m_entities = archetype->GetEntities(chunk);
+                m_columns = GetColumns(*archetype, chunk);
+                return;
+            }
+        }
+
+        template<size_t... Is>
+        Value Dereference(std::index_sequence<Is...>) const {
+            return Value(m_entities[m_row], std::get<Is>(m_columns)[m_row]...);
+        }
+
+    public:
+        Iterator(const std::vector<Archetype*>* archetypes, const Filter* filter, size_t archetype)
+            : m_archetypes(archetypes), m_filter(filter), m_archetype(archetype), m_chunk(0), m_row(0), m_count(0),
+              m_entities(nullptr) {
+            LoadChunk();
+        }
+
+        Value operator*() const { return Dereference(std::index_sequence_for<Ts...>()); }
+
+        Iterator& operator++() {
+            if (++m_row == m_count) {
+                ++m_chunk;
+                LoadChunk();
+            }
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return m_archetype == other.m_archetype && m_chunk == other.m_chunk && m_row == other.m_row;
+        }
+
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+    };
+
+    ComponentView(const std::vector<Archetype*>* archetypes, ChangeTick changedSince, ChangeTick writeTick)
+        : m_archetypes(archetypes) {
+        m_filter.changedSince = changedSince;
+        m_filter.writeTick = writeTick;
+        m_filter.changedCount = 0;
+        m_filter.writtenCount = 0;
+        ((QueryTerm<Ts>::changedFilter
+              ? void(m_filter.changedTypes[m_filter.changedCount++] = ComponentRegistry::TypeId<typename QueryTerm<Ts>::Type>())
+              : void()), ...);
+        ((!std::is_const<typename QueryTerm<Ts>::Type>::value
+              ? void(m_filter.writtenTypes[m_filter.writtenCount++] = ComponentRegistry::TypeId<typename QueryTerm<Ts>::Type>())
+              : void()), ...);
+    }
+
+    // Iterators keep a pointer to this view's filter, so the view must outlive them
+    Iterator begin() const { return Iterator(m_archetypes, &m_filter, 0); }
+    Iterator end() const { return Iterator(m_archetypes, &m_filter, m_archetypes->size()); }
+
+    // Call fn(Entity, Ts&...) for every matching entity
+    template<typename Fn>
+    void Each(Fn&& fn) const {
+        for (const Archetype* archetype : *m_archetypes) {
+            for (size_t i = 0; i < archetype->GetChunkCount(); ++i) {
+                const ArchetypeChunk& chunk = archetype->GetChunk(i);
+                if (m_filter.Accept(*archetype, chunk)) {
+                    EachRow(fn, archetype->GetEntities(chunk), chunk.count, GetColumns(*archetype, chunk),
+                            std::index_sequence_for<Ts...>());
+                }
+            }
+        }
+    }
+
+    // Get the total number of chunks across the matching archetypes (before Changed filtering)
+    size_t GetChunkCount() const {
+        size_t count = 0;
+        for (const Archetype* archetype : *m_archetypes) {
+            count += archetype->GetChunkCount();
+        }
+        return count;
+    }
+
+    // Call fn(Entity, Ts&...) for every row of one chunk, numbering chunks across all matching archetypes.
+    // Chunks rejected by a Changed<T> term are skipped.
+    template<typename Fn>
+    void EachInChunk(size_t chunkIndex, Fn&& fn) const {
+        for (const Archetype* archetype : *m_archetypes) {
+            if (chunkIndex < archetype->GetChunkCount()) {
+                const ArchetypeChunk& chunk = archetype->GetChunk(chunkIndex);
+                if (m_filter.Accept(*archetype, chunk)) {
+                    EachRow(fn, archetype->GetEntities(chunk), chunk.count, GetColumns(*archetype, chunk),
+                            std::index_sequence_for<Ts...>());
+                }
+                return;
+            }
+            chunkIndex -= archetype->GetChunkCount();
+        }
+    }
+
+    // Get the matching archetypes
+    const std::vector<Archetype*>& GetArchetypes() const { return *m_archetypes; }
+
+    // Count the matching entities (before Changed filtering)
+    size_t Count() const {
+        size_t count = 0;
+        for (const Archetype* archetype : *m_archetypes) {
+            count += archetype->GetEntityCount();
+        }
+        return count;
+    }
+
+    // Check if no entity matches (before Changed filtering)
+    bool Empty() const { return Count() == 0; }
+};
+
+/**
+ * @brief Records structural changes for later playback by EntityManager::FlushCommandBuffers
+ *
+ * Each thread records into its own buffer (EntityManager::GetCommandBuffer), so
+ * systems running in parallel can spawn and destroy entities without touching
+ * archetype storage. CreateEntity returns a provisional handle that is only
+ * meaningful to commands recorded in the same buffer; it is not alive and
+ * IsValid() is false until the flush creates the real entity. Component values
+ * are constructed in the buffer's own storage and moved into their chunk on
+ * flush.
+ */
+class EntityCommandBuffer {
+public:
+    enum class CommandType : uint8_t {
+        CreateEntity,
+        DestroyEntity,
+        AddComponent,
+        RemoveComponent
+    };
+
+    struct Command {
+        Entity entity;
+        CommandType type;
+        ComponentTypeId componentType;
+        void* component;
+    };
+
+private:
+    // Size of one block of component storage
+    static constexpr size_t STORAGE_BLOCK_SIZE = 16 * 1024;
+
+    struct StorageBlock {
+        uint8_t* data;
+        size_t size;
+    };
+
+    std::vector<Command> m_commands;
+
+    // Component values, bump allocated; blocks are kept across flushes
+    std::vector<StorageBlock> m_blocks;
+    size_t m_blockIndex;
+    size_t m_blockOffset;
+
+    // Provisional handles handed out since the last flush
+    uint32_t m_provisionalCount;
+
+    void* AllocateStorage(size_t size, size_t alignment) {
+        while (m_blockIndex < m_blocks.size()) {
+            size_t offset = (m_blockOffset + alignment - 1) & ~(alignment - 1);
+            if (offset + size <= m_blocks[m_blockIndex].size) {
+                m_blockOffset = offset + size;
+                return m_blocks[m_blockIndex].data + offset;
+            }
+            ++m_blockIndex;
+            m_blockOffset = 0;
+        }
+        size_t blockSize = std::max(size, STORAGE_BLOCK_SIZE);
+        uint8_t* data = static_cast<uint8_t*>(::operator new(blockSize, std::align_val_t(CACHE_LINE_SIZE)));
+        m_blocks.push_back(StorageBlock{data, blockSize});
+        m_blockIndex = m_blocks.size() - 1;
+        m_blockOffset = size;
+        return data;
+    }
+
+public:
+    EntityCommandBuffer() : m_blockIndex(0), m_blockOffset(0), m_provisionalCount(0) {}
+
+    ~EntityCommandBuffer() {
+        Clear();
+        for (const StorageBlock& block : m_blocks) {
+            ::operator delete(block.data, std::align_val_t(CACHE_LINE_SIZE));
+        }
+    }
+
+    EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+    EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+    // Check if a handle is a provisional handle returned by CreateEntity
+    static bool IsProvisional(Entity entity) { return entity.generation == 0 && entity.index != 0; }
+
+    // Record the creation of an entity and get its provisional handle
+    Entity CreateEntity() {
+        Entity entity(++m_provisionalCount, 0);
+        m_commands.push_back(Command{entity, CommandType::CreateEntity, 0, nullptr});
+        return entity;
+    }
+
+    // Record the destruction of an entity
+    void DestroyEntity(Entity entity) {
+        if (entity != NULL_ENTITY) {
+            m_commands.push_back(Command{entity, CommandType::DestroyEntity, 0, nullptr});
+        }
+    }
+
+    // Record adding a component (an existing component of the same type is replaced)
+    template<typename T, typename... Args>
+    void AddComponent(Entity entity, Args&&... args) {
+        if (entity == NULL_ENTITY) {
+            return;
+        }
+        void* component = new (AllocateStorage(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        m_commands.push_back(Command{entity, CommandType::AddComponent, ComponentRegistry::TypeId<T>(), component});
+    }
+
+    // Record removing a component
+    template<typename T>
+    void RemoveComponent(Entity entity) {
+        if (entity != NULL_ENTITY) {
+            m_commands.push_back(Command{entity, CommandType::RemoveComponent, ComponentRegistry::TypeId<T>(), nullptr});
+        }
+    }
+
+    // Get the recorded commands in recording order
+    const std::vector<Command>& GetCommands() const { return m_commands; }
+
+    // Check if nothing was recorded
+    bool IsEmpty() const { return m_commands.empty(); }
+
+    // Drop all commands and destroy the stored component values (moved-from or not)
+    void Clear() {
+        for (const Command& command : m_commands) {
+            if (command.type == CommandType::AddComponent) {
+                ComponentRegistry::Info(command.componentType).destroy(command.component);
+            }
+        }
+        m_commands.clear();
+        m_blockIndex = 0;
+        m_blockOffset = 0;
+        m_provisionalCount = 0;
+    }
+};
+
+/**
+ * @brief Owns entities, their archetype storage, and the systems that operate on them
+ *
+ * Structural changes (creating or destroying entities, adding or removing
+ * components) must not happen while iterating a view or while systems run in
+ * parallel; record them in a command buffer instead and flush at a sync point.
+ */
+class EntityManager {
+private:
+    // Slot in the entity table. While the slot is free, row links to the next free slot.
+    struct EntitySlot {
+        Archetype* archetype;
+        uint32_t chunk;
+        uint32_t row;
+        uint32_t generation;
+    };
+
+    // End of the free slot list
+    static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFFu;
+
+    // Entity slots indexed by Entity::index (archetype is null for free slots)
+    std::vector<EntitySlot> m_slots;
+
+    // Head of the intrusive list of free slots
+    uint32_t m_freeHead;
+
+    // Number of live entities
+    size_t m_entityCount;
+
+    // Chunk memory of every archetype (declared first so it outlives them)
+    ChunkPool m_chunkPool;
+
+    // Archetypes by component mask
+    std::unordered_map<ComponentMask, std::unique_ptr<Archetype>> m_archetypes;
+
+    // Archetypes in creation order, for iteration (only ever appended to)
+    std::vector<Archetype*> m_archetypeList;
+
+    // Archetypes matching a query, extended lazily when new archetypes appear
+    struct QueryCache {
+        std::vector<Archetype*> archetypes;
+        size_t scannedArchetypes;
+    };
+
+    // Query caches by required component mask. Systems running in parallel look caches up
+    // concurrently, so lookups share the mutex and filling a cache takes it exclusively.
+    std::unordered_map<ComponentMask, QueryCache> m_queryCache;
+    std::shared_mutex m_queryCacheMutex;
+
+    // Archetype of entities without components
+    Archetype* m_emptyArchetype;
+
+    // Registered systems, updated in registration order
+    std::vector<std::unique_ptr<System>> m_systems;
+
+    // Newest tick handed out to a system run
+    std::atomic<ChangeTick> m_changeTick;
+
+    // Per-thread command buffers indexed by ThreadSlot, created on first use
+    std::unique_ptr<std::atomic<EntityCommandBuffer*>[]> m_commandBuffers;
+
+    // Timing wheel of the world that owns this manager (null for a standalone manager)
+    TimingWheel* m_timers;
+
+    // Command of any buffer, tagged with the key it is grouped and sorted by during a flush
+    struct PendingCommand {
+        uint64_t key;
+        const EntityCommandBuffer::Command* command;
+    };
+
+    // Scratch list reused by every flush
+    std::vector<PendingCommand> m_pendingCommands;
+
+    Archetype* GetOrCreateArchetype(ComponentMask mask) {
+        auto it = m_archetypes.find(mask);
+        if (it != m_archetypes.end()) {
+            return it->second.get();
+        }
+        std::unique_ptr<Archetype> archetype = std::make_unique<Archetype>(mask, &m_chunkPool);
+        Archetype* result = archetype.get();
+        m_archetypes.emplace(mask, std::move(archetype));
+        m_archetypeList.push_back(result);
+        return result;
+    }
+
+    // Move an entity's row into another archetype, carrying over the shared components
+    void MoveEntity(Entity entity, Archetype* target) {
+        EntitySlot& slot = m_slots[entity.index];
+        uint32_t chunkIndex = 0;
+        uint32_t row = 0;
+        target->AllocateRow(entity, GetWriteTick(), chunkIndex, row);
+        target->MoveSharedComponents(*slot.archetype, slot.chunk, slot.row, chunkIndex, row);
+        RemoveRow(slot);
+        slot.archetype = target;
+        slot.chunk = chunkIndex;
+        slot.row = row;
+    }
+
+    // Remove a row from its archetype and patch the slot of the entity moved into it
+    void RemoveRow(const EntitySlot& slot) {
+        Entity moved = slot.archetype->RemoveRow(slot.chunk, slot.row);
+        if (moved.IsValid()) {
+            m_slots[moved.index].chunk = slot.chunk;
+            m_slots[moved.index].row = slot.row;
+        }
+    }
+
+    // Get the slot of a live entity
+    const EntitySlot& GetSlot(Entity entity) const { return m_slots[entity.index]; }
+
+    // Take a slot from the free list (or grow the table) and return its handle; the slot has no row yet
+    Entity AllocateEntity() {
+        uint32_t index = m_freeHead;
+        if (index != INVALID_SLOT) {
+            m_freeHead = m_slots[index].row;
+        } else {
+            index = static_cast<uint32_t>(m_slots.size());
+            m_slots.push_back(EntitySlot{nullptr, 0, 0, 1});
+        }
+        ++m_entityCount;
+        return Entity(index, m_slots[index].generation);
+    }
+
+    // Change an entity's component set with at most one archetype move. Removed and replaced
+    // components are finalized; each added component is move-constructed from its source.
+    void ApplyComponentChanges(Entity entity, ComponentMask removeMask, size_t addCount,
+                               const ComponentTypeId* addTypes, void* const* addSources) {
+        EntitySlot& slot = m_slots[entity.index];
+        Archetype* source = slot.archetype;
+        ComponentMask addMask = 0;
+        for (size_t i = 0; i < addCount; ++i) {
+            addMask |= ComponentMask{1} << addTypes[i];
+        }
+        ComponentMask oldMask = source ? source->GetMask() : 0;
+        ComponentMask newMask = (oldMask & ~removeMask) | addMask;
+        ComponentMask keptMask = oldMask & newMask & ~addMask;
+
+        NotifySystems(entity, oldMask, keptMask);
+        for (ComponentTypeId id = 0; source && id < MAX_COMPONENT_TYPES; ++id) {
+            if ((oldMask & ~keptMask) & (ComponentMask{1} << id)) {
+                ComponentRegistry::Info(id).toComponent(source->GetComponent(slot.chunk, slot.row, id))->Finalize();
+            }
+        }
+
+        Archetype* target = source;
+        if (!source || newMask != oldMask) {
+            target = GetOrCreateArchetype(newMask);
+            if (source) {
+                MoveEntity(entity, target);
+            } else {
+                slot.archetype = target;
+                target->AllocateRow(entity, GetWriteTick(), slot.chunk, slot.row);
+            }
+        }
+
+        for (size_t i = 0; i < addCount; ++i) {
+            const ComponentTypeInfo& info = ComponentRegistry::Info(addTypes[i]);
+            void* destination = target->GetComponent(slot.chunk, slot.row, addTypes[i]);
+            if (oldMask & (ComponentMask{1} << addTypes[i])) {
+                // Replaced component: the old value was carried over by the move (or is still in place)
+                info.destroy(destination);
+            }
+            info.moveConstruct(destination, addSources[i]);
+            info.toComponent(destination)->Initialize();
+            target->MarkChanged(target->GetChunk(slot.chunk), addTypes[i], GetWriteTick());
+        }
+        NotifySystems(entity, keptMask, newMask);
+    }
+
+    // Play back one entity's commands (all with the same key, in recording order)
+    void ApplyCommandGroup(const PendingCommand* commands, size_t count) {
+        Entity entity = commands[0].command->entity;
+        bool provisional = EntityCommandBuffer::IsProvisional(entity);
+        bool destroyed = false;
+        ComponentMask removeMask = 0;
+        ComponentMask addMask = 0;
+        void* addSources[MAX_COMPONENT_TYPES];
+
+        for (size_t i = 0; i < count; ++i) {
+            const EntityCommandBuffer::Command& command = *commands[i].command;
+            ComponentMask bit = ComponentMask{1} << command.componentType;
+            switch (command.type) {
+                case EntityCommandBuffer::CommandType::CreateEntity:
+                    break;
+                case EntityCommandBuffer::CommandType::DestroyEntity:
+                    destroyed = true;
+                    break;
+                case EntityCommandBuffer::CommandType::AddComponent:
+                    addSources[command.componentType] = command.component;
+                    addMask |= bit;
+                    break;
+                case EntityCommandBuffer::CommandType::RemoveComponent:
+                    addMask &= ~bit;
+                    removeMask |= bit;
+                    break;
+            }
+        }
+
+        if (destroyed) {
+            if (!provisional) {
+                DestroyEntity(entity);
+            }
+            return;
+        }
+        if (provisional) {
+            entity = AllocateEntity();
+            removeMask = 0;
+        } else if (!IsAlive(entity)) {
+            return;
+        }
+
+        ComponentTypeId addTypes[MAX_COMPONENT_TYPES];
+        void* orderedSources[MAX_COMPONENT_TYPES];
+        size_t addCount = 0;
+        for (ComponentTypeId id = 0; id < MAX_COMPONENT_TYPES; ++id) {
+            if (addMask & (ComponentMask{1} << id)) {
+                addTypes[addCount] = id;
+                orderedSources[addCount] = addSources[id];
+                ++addCount;
+            }
+        }
+        ApplyComponentChanges(entity, removeMask, addCount, addTypes, orderedSources);
+    }
+
+    void NotifySystems(Entity entity, ComponentMask oldMask, ComponentMask newMask) {
+        for (const std::unique_ptr<System>& system : m_systems) {
+            ComponentMask signature = system->GetSignature();
+            if (signature == 0) {
+                continue;
+            }
+            bool wasMatching = (oldMask & signature) == signature;
+            bool isMatching = (newMask & signature) == signature;
+            if (isMatching && !wasMatching) {
+                system->OnEntityAdded(entity);
+            } else if (wasMatching && !isMatching) {
+                system->OnEntityRemoved(entity);
+            }
+        }
+    }
+
+    // Get the archetypes matching a mask, scanning only archetypes created since the last call.
+    // Safe to call from systems running in parallel (which make no structural changes); the returned
+    // list stays valid until the next structural change since map nodes never move.
+    const std::vector<Archetype*>& Query(ComponentMask required) {
+        {
+            std::shared_lock<std::shared_mutex> lock(m_queryCacheMutex);
+            auto it = m_queryCache.find(required);
+            if (it != m_queryCache.end() && it->second.scannedArchetypes == m_archetypeList.size()) {
+                return it->second.archetypes;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(m_queryCacheMutex);
+        QueryCache& cache = m_queryCache[required];
+        for (; cache.scannedArchetypes < m_archetypeList.size(); ++cache.scannedArchetypes) {
+            Archetype* archetype = m_archetypeList[cache.scannedArchetypes];
+            if ((archetype->GetMask() & required) == required) {
+                cache.archetypes.push_back(archetype);
+            }
+        }
+        return cache.archetypes;
+    }
+
+public:
+    // Create an entity manager; chunk memory comes from chunkAllocator if given (e.g. a world's arena),
+    // which must outlive the manager and is never asked to free single chunks
+    explicit EntityManager(Allocator* chunkAllocator = nullptr)
+        : m_freeHead(INVALID_SLOT), m_entityCount(0), m_chunkPool(chunkAllocator), m_emptyArchetype(nullptr), m_changeTick(0),
+          m_commandBuffers(new std::atomic<EntityCommandBuffer*>[ThreadSlot::MAX_SLOTS]), m_timers(nullptr) {
+        m_emptyArchetype = GetOrCreateArchetype(0);
+        for (uint32_t i = 0; i < ThreadSlot::MAX_SLOTS; ++i) {
+            m_commandBuffers[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~EntityManager() {
+        for (uint32_t i = 0; i < ThreadSlot::MAX_SLOTS; ++i) {
+            delete m_commandBuffers[i].load(std::memory_order_relaxed);
+        }
+        m_systems.clear();
+        m_queryCache.clear();
+        m_archetypeList.clear();
+        m_archetypes.clear();
+    }
+
+    EntityManager(const EntityManager&) = delete;
+    EntityManager& operator=(const EntityManager&) = delete;
+
+    // Create an entity without components, reusing a free slot when one is available
+    Entity CreateEntity() {
+        Entity entity = AllocateEntity();
+        EntitySlot& slot = m_slots[entity.index];
+        slot.archetype = m_emptyArchetype;
+        m_emptyArchetype->AllocateRow(entity, GetWriteTick(), slot.chunk, slot.row);
+        return entity;
+    }
+
+    // Destroy an entity and all of its components
+    void DestroyEntity(Entity entity) {
+        if (!IsAlive(entity)) {
+            return;
+        }
+        EntitySlot& slot = m_slots[entity.index];
+        NotifySystems(entity, slot.archetype->GetMask(), 0);
+        for (ComponentTypeId id : slot.archetype->GetTypes()) {
+            ComponentRegistry::Info(id).toComponent(slot.archetype->GetComponent(slot.chunk, slot.row, id))->Finalize();
+        }
+        RemoveRow(slot);
+
+        // Invalidate outstanding handles and push the slot onto the free list
+        if (++slot.generation == 0) {
+            slot.generation = 1;
+        }
+        slot.archetype = nullptr;
+        slot.row = m_freeHead;
+        m_freeHead = entity.index;
+        --m_entityCount;
+    }
+
+    // Destroy every entity at once, e.g. at the end of a match. Systems are not notified per entity
+    // but each gets OnTeardown afterwards, Finalize is not called, components whose type allows it
+    // (SkipDestructorOnTeardown) are dropped without running destructors, and pending commands are
+    // discarded. Outstanding handles become stale; systems stay registered. Chunks go back to the
+    // chunk pool for the next match; call ReleaseChunkMemory before releasing an arena chunk
+    // allocator wholesale.
+    void Teardown() {
+        for (uint32_t i = 0; i < ThreadSlot::MAX_SLOTS; ++i) {
+            if (EntityCommandBuffer* buffer = m_commandBuffers[i].load(std::memory_order_acquire)) {
+                buffer->Clear();
+            }
+        }
+        for (Archetype* archetype : m_archetypeList) {
+            archetype->Clear(true);
+        }
+
+        m_freeHead = INVALID_SLOT;
+        for (uint32_t index = static_cast<uint32_t>(m_slots.size()); index-- > 0;) {
+            EntitySlot& slot = m_slots[index];
+            if (slot.archetype) {
+                if (++slot.generation == 0) {
+                    slot.generation = 1;
+                }
+                slot.archetype = nullptr;
+            }
+            slot.row = m_freeHead;
+            m_freeHead = index;
+        }
+        m_entityCount = 0;
+
+        for (const std::unique_ptr<System>& system : m_systems) {
+            system->OnTeardown();
+        }
+    }
+
+    // After Teardown, forget the pooled chunks (deleting heap ones). Allocator-backed chunks are not
+    // freed one by one; their memory goes away when the allocator is released.
+    void ReleaseChunkMemory() {
+        assert(m_entityCount == 0 && "ReleaseChunkMemory with live entities");
+        m_chunkPool.Release();
+    }
+
+    // Get the chunk pool
+    const ChunkPool& GetChunkPool() const { return m_chunkPool; }
+
+    // Set the timing wheel systems schedule on (World sets its own; must outlive the manager's entities)
+    void SetTimers(TimingWheel* timers) { m_timers = timers; }
+
+    // Get the timing wheel systems schedule on, or null outside a world
+    TimingWheel* GetTimers() const { return m_timers; }
+
+    // Check if an entity is alive
+    bool IsAlive(Entity entity) const {
+        return entity.index < m_slots.size() && m_slots[entity.index].generation == entity.generation;
+    }
+
+    // Get the number of live entities
+    size_t GetEntityCount() const { return m_entityCount; }
+
+    // Add a component to an entity (replaces nothing: returns the existing component if present)
+    template<typename T, typename... Args>
+    T* AddComponent(Entity entity, Args&&... args) {
+        assert(IsAlive(entity));
+        ComponentTypeId id = ComponentRegistry::TypeId<T>();
+        Archetype* source = GetSlot(entity).archetype;
+        if (source->HasType(id)) {
+            return GetComponent<T>(entity);
+        }
+
+        Archetype* target = source->GetAddEdge(id);
+        if (!target) {
+            target = GetOrCreateArchetype(source->GetMask() | (ComponentMask{1} << id));
+            source->SetAddEdge(id, target);
+            target->SetRemoveEdge(id, source);
+        }
+        MoveEntity(entity, target);
+
+        const EntitySlot& slot = GetSlot(entity);
+        T* component = new (target->GetComponent(slot.chunk, slot.row, id)) T(std::forward<Args>(args)...);
+        component->Initialize();
+        NotifySystems(entity, source->GetMask(), target->GetMask());
+        return GetComponent<T>(entity);
+    }
+
+    // Remove a component from an entity
+    template<typename T>
+    void RemoveComponent(Entity entity) {
+        if (!HasComponent<T>(entity)) {
+            return;
+        }
+        ComponentTypeId id = ComponentRegistry::TypeId<T>();
+        Archetype* source = GetSlot(entity).archetype;
+        Archetype* target = source->GetRemoveEdge(id);
+        if (!target) {
+            target = GetOrCreateArchetype(source->GetMask() & ~(ComponentMask{1} << id));
+            source->SetRemoveEdge(id, target);
+            target->SetAddEdge(id, source);
+        }
+
+        NotifySystems(entity, source->GetMask(), target->GetMask());
+        GetComponent<T>(entity)->Finalize();
+        MoveEntity(entity, target);
+    }
+
+    // Get a component of an entity, or null if the entity does not have it.
+    // Asking for a non-const T counts as a write for Changed<T> filters; use GetComponent<const T> to read.
+    template<typename T>
+    T* GetComponent(Entity entity) {
+        if (!HasComponent<T>(entity)) {
+            return nullptr;
+        }
+        const EntitySlot& slot = GetSlot(entity);
+        ComponentTypeId id = ComponentRegistry::TypeId<T>();
+        if (!std::is_const<T>::value) {
+            slot.archetype->MarkChanged(slot.archetype->GetChunk(slot.chunk), id, GetWriteTick());
+        }
+        return static_cast<T*>(slot.archetype->GetComponent(slot.chunk, slot.row, id));
+    }
+
+    // Get a component of an entity for reading, or null if the entity does not have it (never counts as a write)
+    template<typename T>
+    const T* GetComponent(Entity entity) const {
+        if (!HasComponent<T>(entity)) {
+            return nullptr;
+        }
+        const EntitySlot& slot = GetSlot(entity);
+        return static_cast<const T*>(slot.archetype->GetComponent(slot.chunk, slot.row, ComponentRegistry::TypeId<T>()));
+    }
+
+    // Check if an entity has a component
+    template<typename T>
+    bool HasComponent(Entity entity) const {
+        return IsAlive(entity) && GetSlot(entity).archetype->HasType(ComponentRegistry::TypeId<T>());
+    }
+
+    // Get the component mask of an entity
+    ComponentMask GetMask(Entity entity) const {
+        return IsAlive(entity) ? GetSlot(entity).archetype->GetMask() : 0;
+    }
+
+    // Get a view over every entity that has all of the given components (Ts may be wrapped in Changed<>).
+    // Changed<T> terms match chunks written after changedSince; writes are stamped with writeTick,
+    // or with GetWriteTick() when it is 0. Systems should use System::Query instead.
+    template<typename... Ts>
+    ComponentView<Ts...> View(ChangeTick changedSince = 0, ChangeTick writeTick = 0) {
+        return ComponentView<Ts...>(&Query(ComponentRegistry::Mask<typename QueryTerm<Ts>::Type...>()), changedSince,
+                                    writeTick != 0 ? writeTick : GetWriteTick());
+    }
+
+    // Get the tick stamped on writes made outside a system run; newer than every tick handed out so far
+    ChangeTick GetWriteTick() const { return m_changeTick.load(std::memory_order_acquire) + 1; }
+
+    // Hand out the tick for a system run
+    ChangeTick NextRunTick() { return m_changeTick.fetch_add(1, std::memory_order_acq_rel) + 1; }
+
+    // Run one phase of a system with change tracking (used by Update/FixedUpdate and the scheduler)
+    void RunSystem(System& system, bool fixedUpdate, float deltaTime) {
+        system.BeginRun(NextRunTick());
+        if (fixedUpdate) {
+            system.FixedUpdate(deltaTime);
+        } else {
+            system.Update(deltaTime);
+        }
+        system.EndRun();
+    }
+
+    // Call fn(Entity, Ts&...) for every entity that has all of the given components
+    template<typename... Ts, typename Fn>
+    void ForEach(Fn&& fn) { View<Ts...>().Each(std::forward<Fn>(fn)); }
+
+    // Get all archetypes
+    const std::vector<Archetype*>& GetArchetypes() const { return m_archetypeList; }
+
+    // Register a system; the system is constructed with this manager followed by args
+    template<typename T, typename... Args>
+    T* RegisterSystem(Args&&... args) {
+        static_assert(std::is_base_of<System, T>::value, "Systems must derive from System");
+        std::unique_ptr<T> system = std::make_unique<T>(this, std::forward<Args>(args)...);
+        T* result = system.get();
+        m_systems.push_back(std::move(system));
+        result->Initialize();
+
+        // Entities created before the system was registered
+        ComponentMask signature = result->GetSignature();
+        if (signature != 0) {
+            for (const Archetype* archetype : Query(signature)) {
+                for (size_t i = 0; i < archetype->GetChunkCount(); ++i) {
+                    const ArchetypeChunk& chunk = archetype->GetChunk(i);
+                    for (uint32_t row = 0; row < chunk.count; ++row) {
+                        result->OnEntityAdded(archetype->GetEntities(chunk)[row]);
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    // Get the calling thread's command buffer
+    EntityCommandBuffer& GetCommandBuffer() {
+        std::atomic<EntityCommandBuffer*>& entry = m_commandBuffers[ThreadSlot::Current()];
+        EntityCommandBuffer* buffer = entry.load(std::memory_order_acquire);
+        if (!buffer) {
+            // Only the owning thread ever creates its slot's buffer
+            buffer = new EntityCommandBuffer();
+            entry.store(buffer, std::memory_order_release);
+        }
+        return *buffer;
+    }
+
+    // Play back every thread's command buffer. Commands are merged and stably sorted by
+    // entity so that each entity gets at most one archetype move, and new entities are
+    // created directly in their final archetype. Must be called while no system is running.
+    void FlushCommandBuffers() {
+        m_pendingCommands.clear();
+        for (uint32_t slot = 0; slot < ThreadSlot::MAX_SLOTS; ++slot) {
+            EntityCommandBuffer* buffer = m_commandBuffers[slot].load(std::memory_order_acquire);
+            if (!buffer) {
+                continue;
+            }
+            for (const EntityCommandBuffer::Command& command : buffer->GetCommands()) {
+                // Provisional handles are only unique within their buffer
+                uint64_t key = EntityCommandBuffer::IsProvisional(command.entity)
+                    ? (uint64_t{1} << 63) | (static_cast<uint64_t>(slot) << 32) | command.entity.index
+                    : (static_cast<uint64_t>(command.entity.index) << 32) | command.entity.generation;
+                m_pendingCommands.push_back(PendingCommand{key, &command});
+            }
+        }
+        if (m_pendingCommands.empty()) {
+            return;
+        }
+
+        std::stable_sort(m_pendingCommands.begin(), m_pendingCommands.end(),
+                         [](const PendingCommand& a, const PendingCommand& b) { return a.key < b.key; });
+        for (size_t begin = 0; begin < m_pendingCommands.size();) {
+            size_t end = begin + 1;
+            while (end < m_pendingCommands.size() && m_pendingCommands[end].key == m_pendingCommands[begin].key) {
+                ++end;
+            }
+            ApplyCommandGroup(&m_pendingCommands[begin], end - begin);
+            begin = end;
+        }
+
+        m_pendingCommands.clear();
+        for (uint32_t slot = 0; slot < ThreadSlot::MAX_SLOTS; ++slot) {
+            if (EntityCommandBuffer* buffer = m_commandBuffers[slot].load(std::memory_order_acquire)) {
+                buffer->Clear();
+            }
+        }
+    }
+
+    // Get a registered system by type
+    template<typename T>
+    T* GetSystem() const {
+        for (const std::unique_ptr<System>& system : m_systems) {
+            if (T* result = dynamic_cast<T*>(system.get())) {
+                return result;
+            }
+        }
+        return nullptr;
+    }
+
+    // Get the registered systems in registration order
+    const std::vector<std::unique_ptr<System>>& GetSystems() const { return m_systems; }
+
+    // Update all systems serially
+    void Update(float deltaTime) {
+        for (const std::unique_ptr<System>& system : m_systems) {
+            RunSystem(*system, false, deltaTime);
+        }
+    }
+
+    // Fixed update all systems serially
+    void FixedUpdate(float fixedTimeStep) {
+        for (const std::unique_ptr<System>& system : m_systems) {
+            RunSystem(*system, true, fixedTimeStep);
+        }
+    }
+
+    // Render all systems
+    void Render() {
+        for (const std::unique_ptr<System>& system : m_systems) {
+            system->Render();
+        }
+    }
+};
+
+template<typename... Ts>
+ComponentView<Ts...> System::Query() const {
+    return m_entityManager->View<Ts...>(m_lastRunTick, m_runTick != 0 ? m_runTick : m_entityManager->GetWriteTick());
+}
+
+} // namespace CHULUBME
+
+namespace std {
+template<>
+struct hash<CHULUBME::Entity> {
+    size_t operator()(const CHULUBME::Entity& entity) const noexcept { return hash<uint64_t>()(entity.ToId()); }
+};
+} // namespace std
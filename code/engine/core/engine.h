@@ -3,26 +3,65 @@
 #include <string>
 #include <memory>
 #include <chrono>
+#include <vector>
 #include "ecs.h"
+#include "job_system.h"
+#include "scheduler.h"
+#include "tick_clock.h"
+#include "world.h"
 
 namespace CHULUBME {
 
+/**
+ * @brief How the engine drives its main loop
+ */
+enum class EngineMode {
+    // Variable-rate frames with fixed-step simulation, rendering and input
+    Client,
+    // Dedicated server: no RenderSystem or InputManager, FixedUpdate only at the tick rate
+    Headless
+};
+
 /**
  * @brief Main engine class that manages the game loop and subsystems
+ *
+ * The engine owns the process-wide pieces (job system, loop timing, render
+ * and input in client mode) and hosts one or more isolated worlds. Clients
+ * use a single world; dedicated servers host one world per match and step
+ * them in parallel on the shared job system.
  */
 class Engine {
 private:
     // Singleton instance
     static std::unique_ptr<Engine> s_instance;
     
-    // Entity manager
-    std::unique_ptr<EntityManager> m_entityManager;
+    // Work-stealing job system shared by every world and subsystem
+    std::unique_ptr<JobSystem> m_jobSystem;
+    
+    // Hosted worlds; the first one is the default world
+    std::vector<std::unique_ptr<World>> m_worlds;
+    
+    // Number of job workers to create on Initialize, including the main thread (0 = one per hardware thread)
+    size_t m_workerThreadCount;
+    
+    // Loop mode, chosen before Initialize
+    EngineMode m_mode;
     
     // Game loop timing
     std::chrono::steady_clock::time_point m_lastFrameTime;
     float m_deltaTime;
     float m_fixedTimeStep;
-    float m_timeAccumulator;
+    
+    // Most fixed ticks a world may run per frame (fixed-step accumulators live in each World)
+    uint32_t m_maxSubsteps;
+    
+    // Headless tick pacing and per-tick work time
+    TickClock m_tickClock;
+    uint32_t m_tickRate;
+    TickStatistics m_tickStatistics;
+    
+    // Per-tag memory accounting captured at the end of the last Update
+    MemorySnapshot m_memorySnapshot;
     
     // Engine state
     bool m_initialized;
@@ -30,6 +69,43 @@ private:
     
     // Private constructor for singleton
     Engine();
+    
+    // Call fn(World&) for every world, as one job per world when there is more than one
+    template<typename Fn>
+    void ForEachWorld(const Fn& fn) {
+        if (!m_jobSystem || m_worlds.size() < 2) {
+            for (const std::unique_ptr<World>& world : m_worlds) {
+                fn(*world);
+            }
+            return;
+        }
+        m_jobSystem->ParallelFor(m_worlds.size(), 1, [this, &fn](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                fn(*m_worlds[i]);
+            }
+        });
+    }
+    
+    // Client loop: each frame steps the worlds (Update, then at most their max substeps of
+    // FixedUpdate from the accumulator) and renders at the resulting interpolation alpha
+    void RunClient();
+    
+    // Headless loop: each tick is a frame (FrameArena::BeginFrame, then one FixedUpdate, then a
+    // MemoryTracker snapshot), followed by a sleep until the next tick deadline. Nothing is rendered or
+    // polled; the work time of each tick (not the sleep) goes into m_tickStatistics.
+    void RunHeadless() {
+        m_tickClock.SetTickRate(m_tickRate);
+        m_tickClock.Restart();
+        while (m_running) {
+            TickClock::Clock::time_point start = TickClock::Clock::now();
+            FrameArena::BeginFrame();
+            FixedUpdate();
+            m_memorySnapshot = MemoryTracker::TakeSnapshot();
+            TickClock::Clock::time_point end = TickClock::Clock::now();
+            m_tickStatistics.Record(end - start, end > m_tickClock.GetDeadline());
+            m_tickClock.WaitForNextTick();
+        }
+    }
 
 public:
     // Get singleton instance
@@ -38,39 +114,120 @@ public:
     // Destroy singleton instance
     static void DestroyInstance();
     
-    // Initialize the engine
+    // Initialize the engine (headless mode needs no RenderSystem or InputManager: RunHeadless never renders or polls input)
     bool Initialize();
     
     // Shutdown the engine
     void Shutdown();
     
-    // Run the main game loop
+    // Run the main game loop until Stop (dispatches on the engine mode)
     void Run();
     
     // Stop the main game loop
     void Stop();
     
-    // Update the engine for one frame
-    void Update();
+    // Update every world for one frame. Starts by advancing the frame arenas (FrameArena::BeginFrame)
+    // and measuring the frame time, then steps the worlds as parallel jobs (World::Step: each one runs
+    // its systems through its scheduler and flushes its command buffers as the frame's structural sync
+    // point). Ends with a MemoryTracker snapshot.
+    void Update() {
+        FrameArena::BeginFrame();
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        m_deltaTime = std::chrono::duration<float>(now - m_lastFrameTime).count();
+        m_lastFrameTime = now;
+        ForEachWorld([this](World& world) { world.Step(m_deltaTime); });
+        m_memorySnapshot = MemoryTracker::TakeSnapshot();
+    }
+    
+    // Run one fixed step of every world in parallel (does not advance the frame arenas; callers that
+    // drive ticks themselves call FrameArena::BeginFrame once per tick)
+    void FixedUpdate() {
+        ForEachWorld([](World& world) { world.FixedUpdate(); });
+    }
+    
+    // Render the default world, interpolating transforms by its interpolation alpha
+    void Render();
     
-    // Fixed update at a consistent time step
-    void FixedUpdate();
+    // Create a world that runs on the engine's job system
+    World* CreateWorld(const std::string& name);
     
-    // Render the current frame
-    void Render();
+    // Destroy a world and everything it owns (not while it is being stepped)
+    void DestroyWorld(World* world);
+    
+    // Get the hosted worlds
+    const std::vector<std::unique_ptr<World>>& GetWorlds() const { return m_worlds; }
+    
+    // Get the default world (the first one created)
+    World* GetDefaultWorld() const { return m_worlds.empty() ? nullptr : m_worlds.front().get(); }
     
-    // Get the entity manager
-    EntityManager* GetEntityManager() const { return m_entityManager.get(); }
+    // Get the default world's entity manager
+    EntityManager* GetEntityManager() const {
+        World* world = GetDefaultWorld();
+        return world ? world->GetEntityManager() : nullptr;
+    }
+    
+    // Get the default world's system scheduler
+    SystemScheduler* GetScheduler() const {
+        World* world = GetDefaultWorld();
+        return world ? world->GetScheduler() : nullptr;
+    }
+    
+    // Get the job system
+    JobSystem* GetJobSystem() const { return m_jobSystem.get(); }
+    
+    // Set the number of job workers (takes effect on Initialize)
+    void SetWorkerThreadCount(size_t count) { m_workerThreadCount = count; }
     
     // Get the delta time between frames
     float GetDeltaTime() const { return m_deltaTime; }
     
-    // Set the fixed time step for physics and other systems
+    // Set the fixed time step for physics and other systems (applies to worlds created afterwards)
     void SetFixedTimeStep(float timeStep) { m_fixedTimeStep = timeStep; }
     
     // Get the fixed time step
     float GetFixedTimeStep() const { return m_fixedTimeStep; }
     
+    // Set the most fixed ticks a world may run per frame (applies to worlds created afterwards)
+    void SetMaxSubsteps(uint32_t maxSubsteps) { m_maxSubsteps = maxSubsteps; }
+    
+    // Get the most fixed ticks a world may run per frame
+    uint32_t GetMaxSubsteps() const { return m_maxSubsteps; }
+    
+    // Get the default world's interpolation alpha for rendering
+    float GetInterpolationAlpha() const {
+        World* world = GetDefaultWorld();
+        return world ? world->GetInterpolationAlpha() : 0.0f;
+    }
+    
+    // Set the loop mode (takes effect on Initialize)
+    void SetMode(EngineMode mode) { m_mode = mode; }
+    
+    // Get the loop mode
+    EngineMode GetMode() const { return m_mode; }
+    
+    // Check if the engine runs as a headless server
+    bool IsHeadless() const { return m_mode == EngineMode::Headless; }
+    
+    // Set the headless simulation rate in ticks per second (also sets the fixed time step)
+    void SetTickRate(uint32_t ticksPerSecond) {
+        m_tickRate = ticksPerSecond > 0 ? ticksPerSecond : 1;
+        m_tickClock.SetTickRate(m_tickRate);
+        m_fixedTimeStep = m_tickClock.GetPeriodSeconds();
+    }
+    
+    // Get the headless simulation rate in ticks per second
+    uint32_t GetTickRate() const { return m_tickRate; }
+    
+    // Get work-time statistics of headless ticks (excludes time spent sleeping)
+    const TickStatistics& GetTickStatistics() const { return m_tickStatistics; }
+    
+    // Clear the headless tick statistics
+    void ResetTickStatistics() { m_tickStatistics.Reset(); }
+    
+    // Get the per-subsystem memory snapshot taken at the end of the last frame or headless tick (zeros in
+    // shipping builds)
+    const MemorySnapshot& GetMemorySnapshot() const { return m_memorySnapshot; }
+    
     // Check if engine is initialized
     bool IsInitialized() const { return m_initialized; }
     
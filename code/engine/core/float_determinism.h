@@ -0,0 +1,29 @@
+#pragma once
+
+/**
+ * @brief Keep floating-point multiplies and adds from being fused into FMA
+ *
+ * Code between CHULUBME_FP_CONTRACT_OFF_BEGIN and CHULUBME_FP_CONTRACT_OFF_END
+ * rounds every multiply and add on its own whatever -ffp-contract, -march or
+ * -std the engine is built with (GCC fuses across statements under the GNU
+ * dialects' default -ffp-contract=fast, Clang within an expression by
+ * default). Use it around simulation math that has to give bit-identical
+ * results on every machine, SIMD and scalar paths alike. Place the pair at
+ * namespace scope; functions inlined into a guarded function follow its
+ * setting.
+ */
+#if defined(__clang__)
+#define CHULUBME_FP_CONTRACT_OFF_BEGIN _Pragma("float_control(push)") _Pragma("clang fp contract(off)")
+#define CHULUBME_FP_CONTRACT_OFF_END _Pragma("float_control(pop)")
+#elif defined(__GNUC__)
+#define CHULUBME_FP_CONTRACT_OFF_BEGIN _Pragma("GCC push_options") _Pragma("GCC optimize(\"fp-contract=off\")")
+#define CHULUBME_FP_CONTRACT_OFF_END _Pragma("GCC pop_options")
+#elif defined(_MSC_VER)
+// fp_contract cannot be pushed on MSVC; leaving it off for the rest of the translation unit only
+// costs the odd fused multiply-add
+#define CHULUBME_FP_CONTRACT_OFF_BEGIN __pragma(fp_contract(off))
+#define CHULUBME_FP_CONTRACT_OFF_END
+#else
+#define CHULUBME_FP_CONTRACT_OFF_BEGIN
+#define CHULUBME_FP_CONTRACT_OFF_END
+#endif
@@ -0,0 +1,432 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ecs.h"
+
+namespace CHULUBME {
+
+/**
+ * @brief Counts unfinished jobs; JobSystem::Wait returns once it reaches zero
+ */
+class JobCounter {
+private:
+    std::atomic<uint32_t> m_value;
+
+public:
+    JobCounter() : m_value(0) {}
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    // Add outstanding jobs
+    void Add(uint32_t count) { m_value.fetch_add(count, std::memory_order_relaxed); }
+
+    // Mark one job finished
+    void Decrement() { m_value.fetch_sub(1, std::memory_order_release); }
+
+    // Check if every job counted here has finished
+    bool IsDone() const { return m_value.load(std::memory_order_acquire) == 0; }
+};
+
+/**
+ * @brief A unit of work with its callable stored inline
+ */
+struct alignas(CACHE_LINE_SIZE) Job {
+    // Bytes available for the callable
+    static constexpr size_t PAYLOAD_SIZE = CACHE_LINE_SIZE - 3 * sizeof(void*);
+
+    // Runs and then destroys the callable stored in payload
+    void (*invoke)(void* payload);
+
+    // Counter decremented after the job ran (may be null)
+    JobCounter* counter;
+
+    // Whether this pool slot holds a job that has not finished yet
+    std::atomic<bool> inUse;
+
+    // Whether the job was heap allocated because its pool slot was still busy
+    bool heapAllocated;
+
+    alignas(void*) unsigned char payload[PAYLOAD_SIZE];
+};
+
+static_assert(sizeof(Job) == CACHE_LINE_SIZE, "Job must fill exactly one cache line");
+
+/**
+ * @brief Chase-Lev work-stealing deque of job pointers with a fixed capacity
+ *
+ * Only the owning thread calls Push and Pop (LIFO end); any thread may Steal
+ * (FIFO end).
+ */
+class WorkStealingDeque {
+public:
+    static constexpr int64_t CAPACITY = 4096;
+
+private:
+    static constexpr int64_t MASK = CAPACITY - 1;
+    static_assert((CAPACITY & MASK) == 0, "Deque capacity must be a power of two");
+
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_top;
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_bottom;
+    alignas(CACHE_LINE_SIZE) std::atomic<Job*> m_buffer[CAPACITY];
+
+public:
+    WorkStealingDeque() : m_top(0), m_bottom(0) {
+        for (std::atomic<Job*>& slot : m_buffer) {
+            slot.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    // Push a job; returns false if the deque is full
+    bool Push(Job* job) {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        int64_t top = m_top.load(std::memory_order_acquire);
+        if (bottom - top >= CAPACITY) {
+            return false;
+        }
+        m_buffer[bottom & MASK].store(job, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pop the most recently pushed job, or null
+    Job* Pop() {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* job = m_buffer[bottom & MASK].load(std::memory_order_relaxed);
+        if (top == bottom) {
+            // Last job: race thieves for it
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                job = nullptr;
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // Steal the oldest job, or null if the deque is empty or the steal lost a race
+    Job* Steal() {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+        Job* job = m_buffer[top & MASK].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return job;
+    }
+};
+
+/**
+ * @brief Work-stealing job system
+ *
+ * Every worker thread owns a Chase-Lev deque and a ring of reusable Job
+ * slots. The thread that constructs the job system is registered as worker 0
+ * and runs jobs whenever it waits. Threads that are not workers submit into
+ * a shared locked queue. Idle workers steal from random victims and sleep
+ * once no work is left anywhere.
+ */
+class JobSystem {
+private:
+    // Job slots per worker; a slot still running when the ring wraps falls back to the heap
+    static constexpr size_t JOB_POOL_SIZE = 4096;
+
+    struct alignas(CACHE_LINE_SIZE) Worker {
+        WorkStealingDeque deque;
+        std::unique_ptr<Job[]> jobs;
+        size_t nextJob = 0;
+        uint32_t stealSeed = 0;
+    };
+
+    // Identifies which job system and worker slot the current thread belongs to
+    struct ThreadContext {
+        const JobSystem* owner;
+        size_t workerIndex;
+    };
+
+    static ThreadContext& CurrentThread() {
+        static thread_local ThreadContext s_context{nullptr, 0};
+        return s_context;
+    }
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+
+    // Jobs submitted from threads that are not workers
+    std::deque<Job*> m_externalJobs;
+    std::mutex m_externalMutex;
+
+    // Jobs pushed but not yet taken by any thread
+    std::atomic<int64_t> m_queuedJobs;
+
+    // Sleep/wake support for idle workers
+    std::atomic<uint32_t> m_sleepingWorkers;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    std::atomic<bool> m_stopping;
+
+    // Get the calling thread's worker index, or -1 if it is not a worker of this system
+    int64_t GetWorkerIndex() const {
+        const ThreadContext& context = CurrentThread();
+        return context.owner == this ? static_cast<int64_t>(context.workerIndex) : -1;
+    }
+
+    template<typename Fn>
+    static void InvokePayload(void* payload) {
+        Fn* fn = static_cast<Fn*>(payload);
+        (*fn)();
+        fn->~Fn();
+    }
+
+    Job* AllocateJob(int64_t workerIndex) {
+        Job* job = nullptr;
+        if (workerIndex >= 0) {
+            Worker& worker = *m_workers[workerIndex];
+            Job& slot = worker.jobs[worker.nextJob++ & (JOB_POOL_SIZE - 1)];
+            if (!slot.inUse.load(std::memory_order_acquire)) {
+                job = &slot;
+                job->heapAllocated = false;
+            }
+        }
+        if (!job) {
+            job = new Job();
+            job->heapAllocated = true;
+        }
+        job->inUse.store(true, std::memory_order_relaxed);
+        return job;
+    }
+
+    void Enqueue(Job* job, int64_t workerIndex) {
+        m_queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+        if (workerIndex < 0 || !m_workers[workerIndex]->deque.Push(job)) {
+            std::lock_guard<std::mutex> lock(m_externalMutex);
+            m_externalJobs.push_back(job);
+        }
+        if (m_sleepingWorkers.load(std::memory_order_seq_cst) > 0) {
+            { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+            m_sleepCondition.notify_one();
+        }
+    }
+
+    Job* TakeExternalJob() {
+        std::lock_guard<std::mutex> lock(m_externalMutex);
+        if (m_externalJobs.empty()) {
+            return nullptr;
+        }
+        Job* job = m_externalJobs.front();
+        m_externalJobs.pop_front();
+        return job;
+    }
+
+    // Find a job: own deque first, then the external queue, then other workers' deques
+    Job* FindJob(int64_t workerIndex) {
+        Job* job = nullptr;
+        if (workerIndex >= 0) {
+            job = m_workers[workerIndex]->deque.Pop();
+        }
+        if (!job) {
+            job = TakeExternalJob();
+        }
+        if (!job) {
+            size_t count = m_workers.size();
+            size_t start = 0;
+            if (workerIndex >= 0) {
+                uint32_t& seed = m_workers[workerIndex]->stealSeed;
+                seed = seed * 1664525u + 1013904223u;
+                start = (seed >> 8) % count;
+            }
+            for (size_t i = 0; i < count && !job; ++i) {
+                size_t victim = (start + i) % count;
+                if (static_cast<int64_t>(victim) != workerIndex) {
+                    job = m_workers[victim]->deque.Steal();
+                }
+            }
+        }
+        if (job) {
+            m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    void Execute(Job* job) {
+        JobCounter* counter = job->counter;
+        job->invoke(job->payload);
+        if (job->heapAllocated) {
+            delete job;
+        } else {
+            job->inUse.store(false, std::memory_order_release);
+        }
+        if (counter) {
+            counter->Decrement();
+        }
+    }
+
+    void WorkerLoop(size_t workerIndex) {
+        CurrentThread() = ThreadContext{this, workerIndex};
+        int idleSpins = 0;
+        while (!m_stopping.load(std::memory_order_acquire)) {
+            if (Job* job = FindJob(static_cast<int64_t>(workerIndex))) {
+                Execute(job);
+                idleSpins = 0;
+                continue;
+            }
+            if (++idleSpins < 64) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> lock(m_sleepMutex);
+                m_sleepCondition.wait(lock, [this] {
+                    return m_stopping.load(std::memory_order_acquire) || m_queuedJobs.load(std::memory_order_seq_cst) > 0;
+                });
+            }
+            m_sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+            idleSpins = 0;
+        }
+        CurrentThread() = ThreadContext{nullptr, 0};
+    }
+
+public:
+    // Create the job system; a worker count of 0 uses one worker per hardware thread.
+    // The calling thread becomes worker 0, so workerCount - 1 threads are started.
+    explicit JobSystem(size_t workerCount = 0)
+        : m_queuedJobs(0), m_sleepingWorkers(0), m_stopping(false) {
+        if (workerCount == 0) {
+            workerCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (size_t i = 0; i < workerCount; ++i) {
+            std::unique_ptr<Worker> worker = std::make_unique<Worker>();
+            worker->jobs.reset(new Job[JOB_POOL_SIZE]);
+            for (size_t j = 0; j < JOB_POOL_SIZE; ++j) {
+                worker->jobs[j].inUse.store(false, std::memory_order_relaxed);
+            }
+            worker->stealSeed = static_cast<uint32_t>(i * 2654435761u + 1);
+            m_workers.push_back(std::move(worker));
+        }
+
+        CurrentThread() = ThreadContext{this, 0};
+        for (size_t i = 1; i < workerCount; ++i) {
+            m_threads.emplace_back(&JobSystem::WorkerLoop, this, i);
+        }
+    }
+
+    // Stop and join the workers (queued jobs that never ran are dropped)
+    ~JobSystem() {
+        m_stopping.store(true, std::memory_order_release);
+        { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+        m_sleepCondition.notify_all();
+        for (std::thread& thread : m_threads) {
+            thread.join();
+        }
+        for (Job* job : m_externalJobs) {
+            if (job->heapAllocated) {
+                delete job;
+            }
+        }
+        if (CurrentThread().owner == this) {
+            CurrentThread() = ThreadContext{nullptr, 0};
+        }
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Get the number of workers, including the thread that created the job system
+    size_t GetWorkerCount() const { return m_workers.size(); }
+
+    // Submit a job; fn must be callable as fn() and small enough to store inline.
+    // If a counter is given it is incremented now and decremented when the job finishes.
+    template<typename Fn>
+    void Run(Fn&& fn, JobCounter* counter = nullptr) {
+        using Callable = std::decay_t<Fn>;
+        static_assert(sizeof(Callable) <= Job::PAYLOAD_SIZE, "Job callable too large; capture by reference");
+        static_assert(alignof(Callable) <= alignof(void*), "Job callable over-aligned");
+
+        int64_t workerIndex = GetWorkerIndex();
+        Job* job = AllocateJob(workerIndex);
+        job->invoke = &InvokePayload<Callable>;
+        job->counter = counter;
+        new (job->payload) Callable(std::forward<Fn>(fn));
+        if (counter) {
+            counter->Add(1);
+        }
+        Enqueue(job, workerIndex);
+    }
+
+    // Run other jobs on the calling thread until every job on the counter has finished
+    void Wait(const JobCounter& counter) {
+        int64_t workerIndex = GetWorkerIndex();
+        while (!counter.IsDone()) {
+            if (Job* job = FindJob(workerIndex)) {
+                Execute(job);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Call fn(begin, end) over [0, count) in batches of batchSize across all workers and wait for completion
+    template<typename Fn>
+    void ParallelFor(size_t count, size_t batchSize, const Fn& fn) {
+        if (count == 0) {
+            return;
+        }
+        batchSize = std::max<size_t>(batchSize, 1);
+        const size_t batchCount = (count + batchSize - 1) / batchSize;
+        std::atomic<size_t> nextBatch(0);
+        auto runBatches = [&] {
+            for (size_t batch = nextBatch.fetch_add(1, std::memory_order_relaxed); batch < batchCount;
+                 batch = nextBatch.fetch_add(1, std::memory_order_relaxed)) {
+                size_t begin = batch * batchSize;
+                fn(begin, std::min(begin + batchSize, count));
+            }
+        };
+
+        // One job per helping worker; each keeps claiming batches until none are left
+        JobCounter counter;
+        size_t helpers = std::min(batchCount, m_workers.size()) - 1;
+        for (size_t i = 0; i < helpers; ++i) {
+            Run([&runBatches] { runBatches(); }, &counter);
+        }
+        runBatches();
+        Wait(counter);
+    }
+
+    // Call fn(Entity, Ts&...) for every entity of a view, one archetype chunk per batch
+    template<typename... Ts, typename Fn>
+    void ParallelFor(const ComponentView<Ts...>& view, const Fn& fn) {
+        ParallelFor(view.GetChunkCount(), 1, [&view, &fn](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk < end; ++chunk) {
+                view.EachInChunk(chunk, fn);
+            }
+        });
+    }
+};
+
+} // namespace CHULUBME
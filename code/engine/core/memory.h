@@ -1,11 +1,30 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <cstddef>
+#include <initializer_list>
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 #include <mutex>
+#include "memory_tracking.h"
+#include "thread_slot.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
 
 namespace CHULUBME {
 
@@ -14,137 +33,1521 @@ namespace CHULUBME {
  */
 class Allocator {
 public:
-    virtual ~Allocator() = default;
+    virtual ~Allocator() = default;
+    
+    // Allocate memory of specified size with optional alignment
+    virtual void* Allocate(size_t size, size_t alignment = 0) = 0;
+    
+    // Free previously allocated memory
+    virtual void Free(void* ptr) = 0;
+    
+    // Get the total size of allocated memory
+    virtual size_t GetAllocatedSize() const = 0;
+    
+    // Get the total size of the memory pool
+    virtual size_t GetTotalSize() const = 0;
+    
+    // Check whether Allocate and Free charge the calling thread's current MemoryTag themselves
+    virtual bool ChargesCurrentTag() const { return false; }
+};
+
+/**
+ * @brief Linear allocator - allocates memory linearly, can only free all memory at once
+ */
+class LinearAllocator : public Allocator {
+private:
+    uint8_t* m_memory;
+    size_t m_size;
+    size_t m_offset;
+    bool m_ownsMemory;
+
+public:
+    // Create a linear allocator with a specified size
+    LinearAllocator(size_t size);
+    
+    // Create a linear allocator with pre-allocated memory
+    LinearAllocator(void* memory, size_t size);
+    
+    // Destructor
+    ~LinearAllocator() override;
+    
+    // Allocate memory
+    void* Allocate(size_t size, size_t alignment = 0) override;
+    
+    // Free all memory (individual frees are not supported)
+    void Free(void* ptr) override;
+    
+    // Reset the allocator (free all memory)
+    void Reset();
+    
+    // Get the total size of allocated memory
+    size_t GetAllocatedSize() const override { return m_offset; }
+    
+    // Get the total size of the memory pool
+    size_t GetTotalSize() const override { return m_size; }
+};
+
+/**
+ * @brief Options for allocators backed by reserved virtual memory
+ */
+struct VirtualMemoryOptions {
+    // Physical memory is committed in multiples of this many bytes
+    size_t commitGranularity = 64 * 1024;
+    
+    // Align the range to 2 MB and ask the kernel to back it with transparent huge pages (Linux)
+    bool transparentHugePages = false;
+};
+
+/**
+ * @brief A reserved range of address space whose pages are committed on demand
+ *
+ * Reserve takes address space only (PROT_NONE / MEM_RESERVE); Commit makes
+ * a prefix of it usable, and Decommit returns the physical pages past a
+ * point to the OS while keeping the addresses. Memory never moves, so
+ * pointers into the range stay valid as it grows.
+ */
+class VirtualMemoryRange {
+public:
+    // Size and alignment of a transparent huge page
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+private:
+    uint8_t* m_base;
+    size_t m_reserved;
+    size_t m_committed;
+    size_t m_granularity;
+    
+    // Start and length of the whole mapping (wider than the range when it was aligned for huge pages)
+    void* m_mapping;
+    size_t m_mappingSize;
+    
+    static size_t RoundUp(size_t value, size_t multiple) { return (value + multiple - 1) / multiple * multiple; }
+
+public:
+    VirtualMemoryRange()
+        : m_base(nullptr), m_reserved(0), m_committed(0), m_granularity(0), m_mapping(nullptr), m_mappingSize(0) {}
+    
+    // Reserve reserveSize bytes of address space
+    explicit VirtualMemoryRange(size_t reserveSize, const VirtualMemoryOptions& options = VirtualMemoryOptions())
+        : VirtualMemoryRange() {
+        Reserve(reserveSize, options);
+    }
+    
+    ~VirtualMemoryRange() { Release(); }
+    
+    VirtualMemoryRange(const VirtualMemoryRange&) = delete;
+    VirtualMemoryRange& operator=(const VirtualMemoryRange&) = delete;
+    
+    // Reserve address space; returns false if the OS refuses
+    bool Reserve(size_t reserveSize, const VirtualMemoryOptions& options = VirtualMemoryOptions()) {
+        Release();
+        size_t alignment = options.transparentHugePages ? HUGE_PAGE_SIZE : 4096;
+        m_granularity = RoundUp(options.commitGranularity > 0 ? options.commitGranularity : 1, alignment);
+        m_reserved = RoundUp(reserveSize, m_granularity);
+        m_mappingSize = m_reserved + (options.transparentHugePages ? HUGE_PAGE_SIZE : 0);
+#if defined(__unix__) || defined(__APPLE__)
+        void* mapping = mmap(nullptr, m_mappingSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (mapping == MAP_FAILED) {
+            m_reserved = m_mappingSize = 0;
+            return false;
+        }
+#elif defined(_WIN32)
+        void* mapping = VirtualAlloc(nullptr, m_mappingSize, MEM_RESERVE, PAGE_NOACCESS);
+        if (!mapping) {
+            m_reserved = m_mappingSize = 0;
+            return false;
+        }
+#else
+        void* mapping = ::operator new(m_mappingSize, std::nothrow);
+        if (!mapping) {
+            m_reserved = m_mappingSize = 0;
+            return false;
+        }
+#endif
+        m_mapping = mapping;
+        uintptr_t base = (reinterpret_cast<uintptr_t>(mapping) + alignment - 1) & ~(uintptr_t{alignment} - 1);
+        m_base = reinterpret_cast<uint8_t*>(base);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if (options.transparentHugePages) {
+            madvise(m_base, m_reserved, MADV_HUGEPAGE);
+        }
+#endif
+        return true;
+    }
+    
+    // Make [0, size) usable, committing whole granules; returns false past the reservation
+    bool Commit(size_t size) {
+        if (size <= m_committed) {
+            return true;
+        }
+        if (size > m_reserved) {
+            return false;
+        }
+        size_t target = RoundUp(size, m_granularity);
+        if (target > m_reserved) {
+            target = m_reserved;
+        }
+#if defined(__unix__) || defined(__APPLE__)
+        if (mprotect(m_base + m_committed, target - m_committed, PROT_READ | PROT_WRITE) != 0) {
+            return false;
+        }
+#elif defined(_WIN32)
+        if (!VirtualAlloc(m_base + m_committed, target - m_committed, MEM_COMMIT, PAGE_READWRITE)) {
+            return false;
+        }
+#endif
+        m_committed = target;
+        return true;
+    }
+    
+    // Return physical pages past keepSize (rounded up to a granule) to the OS
+    void Decommit(size_t keepSize) {
+        size_t keep = RoundUp(keepSize, m_granularity);
+        if (keep >= m_committed) {
+            return;
+        }
+#if defined(__unix__) || defined(__APPLE__)
+        madvise(m_base + keep, m_committed - keep, MADV_DONTNEED);
+        mprotect(m_base + keep, m_committed - keep, PROT_NONE);
+#elif defined(_WIN32)
+        VirtualFree(m_base + keep, m_committed - keep, MEM_DECOMMIT);
+#endif
+        m_committed = keep;
+    }
+    
+    // Give the whole range back to the OS
+    void Release() {
+        if (!m_mapping) {
+            return;
+        }
+#if defined(__unix__) || defined(__APPLE__)
+        munmap(m_mapping, m_mappingSize);
+#elif defined(_WIN32)
+        VirtualFree(m_mapping, 0, MEM_RELEASE);
+#else
+        ::operator delete(m_mapping);
+#endif
+        m_mapping = nullptr;
+        m_base = nullptr;
+        m_reserved = m_committed = m_mappingSize = 0;
+    }
+    
+    // Bump-allocate size bytes at or after offset, committing pages as needed, and advance offset past
+    // them (alignment 0 means alignof(std::max_align_t)). Returns null and leaves offset unchanged if
+    // the block does not fit in the reservation.
+    void* BumpAllocate(size_t& offset, size_t size, size_t alignment) {
+        alignment = alignment > 0 ? alignment : alignof(std::max_align_t);
+        uintptr_t base = reinterpret_cast<uintptr_t>(m_base);
+        size_t start = static_cast<size_t>(((base + offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - base);
+        if (!m_base || start + size > m_reserved || !Commit(start + size)) {
+            return nullptr;
+        }
+        offset = start + size;
+        return m_base + start;
+    }
+    
+    // Get the start of the range
+    uint8_t* GetBase() const { return m_base; }
+    
+    // Get the reserved size
+    size_t GetReservedSize() const { return m_reserved; }
+    
+    // Get the committed (usable) size
+    size_t GetCommittedSize() const { return m_committed; }
+};
+
+/**
+ * @brief Arena allocator - a growable chain of linear blocks released all at once
+ *
+ * Allocation bumps an atomic offset in the current block, so any number of
+ * threads can allocate concurrently; only chaining a new block (each twice
+ * the size of the last, up to m_maxBlockSize) takes a lock. Individual
+ * frees are no-ops. Release drops every block except the largest one, which
+ * is kept for the next user, so tearing down everything allocated here
+ * costs a handful of frees regardless of how many allocations were made.
+ * Each allocation is charged to the calling thread's current MemoryTag, and
+ * Release hands every tag's bytes back in one go.
+ */
+class ArenaAllocator : public Allocator {
+private:
+    struct alignas(64) Block {
+        Block* next;
+        size_t size;
+        std::atomic<size_t> offset;
+        
+        uint8_t* Data() { return reinterpret_cast<uint8_t*>(this + 1); }
+    };
+    
+    std::atomic<Block*> m_current;
+    size_t m_maxBlockSize;
+    std::atomic<size_t> m_allocatedSize;
+    std::atomic<size_t> m_totalSize;
+    std::mutex m_growMutex;
+#if CHULUBME_MEMORY_TRACKING
+    // Bytes charged to each tag since the last Release
+    std::atomic<size_t> m_taggedSize[static_cast<size_t>(MemoryTag::Count)] = {};
+#endif
+    
+    // Release every tag's charged bytes
+    void ReleaseCharges() {
+#if CHULUBME_MEMORY_TRACKING
+        for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); ++i) {
+            size_t size = m_taggedSize[i].exchange(0, std::memory_order_relaxed);
+            if (size != 0) {
+                MemoryTracker::RecordFree(static_cast<MemoryTag>(i), size);
+            }
+        }
+#endif
+    }
+    
+    Block* NewBlock(size_t size, Block* next) {
+        void* memory = ::operator new(sizeof(Block) + size, std::align_val_t(alignof(Block)));
+        Block* block = new (memory) Block;
+        block->next = next;
+        block->size = size;
+        block->offset.store(0, std::memory_order_relaxed);
+        m_totalSize.fetch_add(size, std::memory_order_relaxed);
+        return block;
+    }
+    
+    void DeleteBlock(Block* block) {
+        m_totalSize.fetch_sub(block->size, std::memory_order_relaxed);
+        block->~Block();
+        ::operator delete(block, std::align_val_t(alignof(Block)));
+    }
+    
+    // Chain a block that can hold needed bytes, unless another thread already replaced full
+    void Grow(Block* full, size_t needed) {
+        std::lock_guard<std::mutex> lock(m_growMutex);
+        if (m_current.load(std::memory_order_relaxed) != full) {
+            return;
+        }
+        size_t size = full->size * 2 < m_maxBlockSize ? full->size * 2 : m_maxBlockSize;
+        m_current.store(NewBlock(size > needed ? size : needed, full), std::memory_order_release);
+    }
+
+public:
+    // Create an arena whose first block holds initialSize bytes
+    explicit ArenaAllocator(size_t initialSize = 1024 * 1024, size_t maxBlockSize = 64 * 1024 * 1024)
+        : m_current(nullptr), m_maxBlockSize(maxBlockSize), m_allocatedSize(0), m_totalSize(0) {
+        m_current.store(NewBlock(initialSize, nullptr), std::memory_order_relaxed);
+    }
+    
+    // Destructor (releases every block)
+    ~ArenaAllocator() override {
+        ReleaseCharges();
+        for (Block* block = m_current.load(std::memory_order_relaxed); block;) {
+            Block* next = block->next;
+            DeleteBlock(block);
+            block = next;
+        }
+    }
+    
+    ArenaAllocator(const ArenaAllocator&) = delete;
+    ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+    
+    // Allocate memory from any thread (alignment 0 means alignof(std::max_align_t))
+    void* Allocate(size_t size, size_t alignment = 0) override {
+        if (alignment == 0) {
+            alignment = alignof(std::max_align_t);
+        }
+        size_t reserve = size + alignment - 1;
+        for (;;) {
+            Block* block = m_current.load(std::memory_order_acquire);
+            size_t offset = block->offset.fetch_add(reserve, std::memory_order_relaxed);
+            if (offset + reserve <= block->size) {
+                uintptr_t address = reinterpret_cast<uintptr_t>(block->Data()) + offset;
+                address = (address + alignment - 1) & ~(uintptr_t{alignment} - 1);
+                m_allocatedSize.fetch_add(size, std::memory_order_relaxed);
+#if CHULUBME_MEMORY_TRACKING
+                MemoryTag tag = MemoryTracker::ChargeCurrentTag(size);
+                if (tag != MemoryTag::Count) {
+                    m_taggedSize[static_cast<size_t>(tag)].fetch_add(size, std::memory_order_relaxed);
+                }
+#endif
+                return reinterpret_cast<void*>(address);
+            }
+            Grow(block, reserve);
+        }
+    }
+    
+    // Individual frees are not supported; memory is reclaimed by Release
+    void Free(void*) override {}
+    
+    // Free everything at once, keeping the largest block for reuse (no allocation may be in flight)
+    void Release() {
+        Block* largest = m_current.load(std::memory_order_relaxed);
+        for (Block* block = largest->next; block;) {
+            Block* next = block->next;
+            DeleteBlock(block);
+            block = next;
+        }
+        largest->next = nullptr;
+        largest->offset.store(0, std::memory_order_relaxed);
+        m_allocatedSize.store(0, std::memory_order_relaxed);
+        ReleaseCharges();
+    }
+    
+    // Get the total size of allocated memory
+    size_t GetAllocatedSize() const override { return m_allocatedSize.load(std::memory_order_relaxed); }
+    
+    // Get the total size of all blocks
+    size_t GetTotalSize() const override { return m_totalSize.load(std::memory_order_relaxed); }
+    
+    // Allocations are charged to the current tag
+    bool ChargesCurrentTag() const override { return true; }
+};
+
+/**
+ * @brief Pool allocator - allocates fixed-size blocks of memory
+ */
+class PoolAllocator : public Allocator {
+private:
+    uint8_t* m_memory;
+    size_t m_blockSize;
+    size_t m_blockCount;
+    size_t m_freeBlocks;
+    void* m_freeList;
+    bool m_ownsMemory;
+
+public:
+    // Create a pool allocator with specified block size and count
+    PoolAllocator(size_t blockSize, size_t blockCount);
+    
+    // Create a pool allocator with pre-allocated memory
+    PoolAllocator(void* memory, size_t blockSize, size_t blockCount);
+    
+    // Destructor
+    ~PoolAllocator() override;
+    
+    // Allocate a block of memory
+    void* Allocate(size_t size, size_t alignment = 0) override;
+    
+    // Free a block of memory
+    void Free(void* ptr) override;
+    
+    // Get the total size of allocated memory
+    size_t GetAllocatedSize() const override { return (m_blockCount - m_freeBlocks) * m_blockSize; }
+    
+    // Get the total size of the memory pool
+    size_t GetTotalSize() const override { return m_blockCount * m_blockSize; }
+};
+
+/**
+ * @brief Thread-safe pool allocator - fixed-size blocks shared by many threads without a lock
+ *
+ * Each thread keeps a magazine of free blocks and allocates and frees from it
+ * without synchronisation. An empty magazine refills with a whole batch from
+ * the shared free list, and a full one drains half its blocks back as one
+ * batch, so the shared list sees one compare-and-swap per batch rather than
+ * per block. The shared list is a Treiber stack of batches whose head packs a
+ * block index with an ABA tag into one 64-bit word. Blocks cached in other
+ * threads' magazines are not visible to a thread whose magazine and the
+ * shared list are both empty, so size the pool with some headroom
+ * (MAGAZINE_SIZE blocks per thread) or have threads call FlushThreadCache.
+ * Each block remembers the MemoryTag that was current when it was handed
+ * out, so freeing it from another thread releases the right tag.
+ */
+class ConcurrentPoolAllocator : public Allocator {
+public:
+    // Blocks moved between a magazine and the shared free list at a time
+    static constexpr uint32_t BATCH_SIZE = 32;
+    
+    // Blocks a magazine can hold
+    static constexpr uint32_t MAGAZINE_SIZE = BATCH_SIZE * 2;
+    
+    // Alignment of every block
+    static constexpr size_t BLOCK_ALIGNMENT = 16;
+
+private:
+    static constexpr uint32_t NULL_INDEX = ~uint32_t{0};
+    
+    // Overlaid on the first bytes of a free block at the head of a batch
+    struct FreeBatch {
+        std::atomic<uint32_t> nextBatch;
+        uint32_t count;
+    };
+    
+    struct alignas(64) Magazine {
+        uint32_t count = 0;
+        void* blocks[MAGAZINE_SIZE];
+    };
+    
+    uint8_t* m_memory;
+    size_t m_blockSize;
+    size_t m_blockCount;
+    bool m_ownsMemory;
+    
+    // Packed (tag << 32 | index of the first block of the top batch)
+    std::atomic<uint64_t> m_head;
+    
+    // Blocks handed out and not yet freed
+    std::atomic<size_t> m_allocatedBlocks;
+    
+    // Per-thread magazines indexed by ThreadSlot, created on first use
+    std::unique_ptr<std::atomic<Magazine*>[]> m_magazines;
+#if CHULUBME_MEMORY_TRACKING
+    // Tag each block was charged to, indexed by block
+    std::unique_ptr<MemoryTag[]> m_blockTags;
+#endif
+    
+    uint8_t* BlockAt(uint32_t index) const { return m_memory + index * m_blockSize; }
+    
+    uint32_t IndexOf(const void* block) const {
+        return static_cast<uint32_t>((static_cast<const uint8_t*>(block) - m_memory) / m_blockSize);
+    }
+    
+    // Batch members after the head are stored right behind their head's FreeBatch
+    static void** BatchBlocks(uint8_t* head) { return reinterpret_cast<void**>(head + sizeof(FreeBatch)); }
+    
+    Magazine& LocalMagazine() {
+        std::atomic<Magazine*>& slot = m_magazines[ThreadSlot::Current()];
+        Magazine* magazine = slot.load(std::memory_order_acquire);
+        if (!magazine) {
+            magazine = new Magazine();
+            slot.store(magazine, std::memory_order_release);
+        }
+        return *magazine;
+    }
+    
+    // Link count blocks into one batch headed by blocks[0] and push it with a single CAS
+    void PushBatch(void* const* blocks, uint32_t count) {
+        uint8_t* head = static_cast<uint8_t*>(blocks[0]);
+        FreeBatch* batch = new (head) FreeBatch;
+        batch->count = count;
+        
+        // Chain the rest through their first word when the head block is too small to list them
+        void** members = BatchBlocks(head);
+        size_t inlineCapacity = (m_blockSize - sizeof(FreeBatch)) / sizeof(void*);
+        if (count - 1 <= inlineCapacity) {
+            for (uint32_t i = 1; i < count; ++i) {
+                members[i - 1] = blocks[i];
+            }
+        } else {
+            members[0] = blocks[1];
+            for (uint32_t i = 1; i + 1 < count; ++i) {
+                *static_cast<void**>(blocks[i]) = blocks[i + 1];
+            }
+        }
+        
+        uint32_t index = IndexOf(head);
+        uint64_t oldHead = m_head.load(std::memory_order_relaxed);
+        uint64_t newHead;
+        do {
+            batch->nextBatch.store(static_cast<uint32_t>(oldHead), std::memory_order_relaxed);
+            newHead = ((oldHead >> 32) + 1) << 32 | index;
+        } while (!m_head.compare_exchange_weak(oldHead, newHead, std::memory_order_release, std::memory_order_relaxed));
+    }
+    
+    // Pop one batch into the magazine; returns false if the shared list is empty
+    bool PopBatch(Magazine& magazine) {
+        uint64_t oldHead = m_head.load(std::memory_order_acquire);
+        uint8_t* head;
+        for (;;) {
+            uint32_t index = static_cast<uint32_t>(oldHead);
+            if (index == NULL_INDEX) {
+                return false;
+            }
+            head = BlockAt(index);
+            // May read a block another thread has just popped; the tag then fails the CAS
+            uint32_t next = reinterpret_cast<FreeBatch*>(head)->nextBatch.load(std::memory_order_relaxed);
+            uint64_t newHead = ((oldHead >> 32) + 1) << 32 | next;
+            if (m_head.compare_exchange_weak(oldHead, newHead, std::memory_order_acquire, std::memory_order_acquire)) {
+                break;
+            }
+        }
+        
+        uint32_t count = reinterpret_cast<FreeBatch*>(head)->count;
+        void** members = BatchBlocks(head);
+        size_t inlineCapacity = (m_blockSize - sizeof(FreeBatch)) / sizeof(void*);
+        if (count - 1 <= inlineCapacity) {
+            for (uint32_t i = 1; i < count; ++i) {
+                magazine.blocks[magazine.count++] = members[i - 1];
+            }
+        } else {
+            void* block = members[0];
+            for (uint32_t i = 1; i < count; ++i) {
+                magazine.blocks[magazine.count++] = block;
+                block = *static_cast<void**>(block);
+            }
+        }
+        magazine.blocks[magazine.count++] = head;
+        return true;
+    }
+    
+    void Build() {
+        m_head.store(NULL_INDEX, std::memory_order_relaxed);
+        m_allocatedBlocks.store(0, std::memory_order_relaxed);
+        m_magazines.reset(new std::atomic<Magazine*>[ThreadSlot::MAX_SLOTS]);
+        for (uint32_t i = 0; i < ThreadSlot::MAX_SLOTS; ++i) {
+            m_magazines[i].store(nullptr, std::memory_order_relaxed);
+        }
+#if CHULUBME_MEMORY_TRACKING
+        m_blockTags.reset(new MemoryTag[m_blockCount]);
+#endif
+        
+        // Push in reverse so the first batches handed out are at the start of the pool
+        void* batch[BATCH_SIZE];
+        for (size_t end = m_blockCount; end > 0;) {
+            size_t begin = end > BATCH_SIZE ? end - BATCH_SIZE : 0;
+            for (size_t i = begin; i < end; ++i) {
+                batch[i - begin] = BlockAt(static_cast<uint32_t>(i));
+            }
+            PushBatch(batch, static_cast<uint32_t>(end - begin));
+            end = begin;
+        }
+    }
+    
+    static size_t RoundBlockSize(size_t blockSize) {
+        size_t minimum = sizeof(FreeBatch) + sizeof(void*);
+        size_t size = blockSize > minimum ? blockSize : minimum;
+        return (size + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1);
+    }
+
+public:
+    // Create a pool of blockCount blocks of at least blockSize bytes each
+    ConcurrentPoolAllocator(size_t blockSize, size_t blockCount)
+        : m_memory(nullptr), m_blockSize(RoundBlockSize(blockSize)), m_blockCount(blockCount), m_ownsMemory(true) {
+        m_memory = static_cast<uint8_t*>(::operator new(m_blockSize * m_blockCount, std::align_val_t(64)));
+        Build();
+    }
+    
+    // Create a pool over pre-allocated memory (aligned to BLOCK_ALIGNMENT, blockCount * rounded block size bytes)
+    ConcurrentPoolAllocator(void* memory, size_t blockSize, size_t blockCount)
+        : m_memory(static_cast<uint8_t*>(memory)), m_blockSize(RoundBlockSize(blockSize)), m_blockCount(blockCount),
+          m_ownsMemory(false) {
+        Build();
+    }
+    
+    // Destructor (every block must have been freed and no thread may still be using the pool)
+    ~ConcurrentPoolAllocator() override {
+        for (uint32_t i = 0; i < ThreadSlot::MAX_SLOTS; ++i) {
+            delete m_magazines[i].load(std::memory_order_acquire);
+        }
+        if (m_ownsMemory) {
+            ::operator delete(m_memory, std::align_val_t(64));
+        }
+    }
+    
+    ConcurrentPoolAllocator(const ConcurrentPoolAllocator&) = delete;
+    ConcurrentPoolAllocator& operator=(const ConcurrentPoolAllocator&) = delete;
+    
+    // Allocate a block; returns nullptr if size or alignment exceed the block or the pool is exhausted
+    void* Allocate(size_t size, size_t alignment = 0) override {
+        if (size > m_blockSize || alignment > BLOCK_ALIGNMENT) {
+            return nullptr;
+        }
+        Magazine& magazine = LocalMagazine();
+        if (magazine.count == 0 && !PopBatch(magazine)) {
+            return nullptr;
+        }
+        m_allocatedBlocks.fetch_add(1, std::memory_order_relaxed);
+        void* block = magazine.blocks[--magazine.count];
+#if CHULUBME_MEMORY_TRACKING
+        m_blockTags[IndexOf(block)] = MemoryTracker::ChargeCurrentTag(m_blockSize);
+#endif
+        return block;
+    }
+    
+    // Free a block (from any thread)
+    void Free(void* ptr) override {
+        if (!ptr) {
+            return;
+        }
+#if CHULUBME_MEMORY_TRACKING
+        MemoryTracker::ReleaseCharge(m_blockTags[IndexOf(ptr)], m_blockSize);
+#endif
+        Magazine& magazine = LocalMagazine();
+        if (magazine.count == MAGAZINE_SIZE) {
+            magazine.count -= BATCH_SIZE;
+            PushBatch(magazine.blocks + magazine.count, BATCH_SIZE);
+        }
+        magazine.blocks[magazine.count++] = ptr;
+        m_allocatedBlocks.fetch_sub(1, std::memory_order_relaxed);
+    }
+    
+    // Return the calling thread's cached blocks to the shared list (e.g. before the thread exits)
+    void FlushThreadCache() {
+        Magazine& magazine = LocalMagazine();
+        while (magazine.count > 0) {
+            uint32_t count = magazine.count < BATCH_SIZE ? magazine.count : BATCH_SIZE;
+            magazine.count -= count;
+            PushBatch(magazine.blocks + magazine.count, count);
+        }
+    }
+    
+    // Check if a pointer belongs to this pool
+    bool Owns(const void* ptr) const {
+        const uint8_t* p = static_cast<const uint8_t*>(ptr);
+        return p >= m_memory && p < m_memory + m_blockSize * m_blockCount;
+    }
+    
+    // Get the size of one block
+    size_t GetBlockSize() const { return m_blockSize; }
+    
+    // Get the total size of allocated memory
+    size_t GetAllocatedSize() const override { return m_allocatedBlocks.load(std::memory_order_relaxed) * m_blockSize; }
+    
+    // Get the total size of the memory pool
+    size_t GetTotalSize() const override { return m_blockCount * m_blockSize; }
+    
+    // Allocations are charged to the current tag
+    bool ChargesCurrentTag() const override { return true; }
+};
+
+/**
+ * @brief Stack allocator - allocates memory in a stack-like fashion
+ */
+class StackAllocator : public Allocator {
+public:
+    // Position of the stack top, restored by FreeToMarker
+    struct Marker {
+        size_t offset;
+        size_t adjustment;
+    };
+
+private:
+    uint8_t* m_memory;
+    size_t m_size;
+    size_t m_offset;
+    bool m_ownsMemory;
+
+public:
+    // Create a stack allocator with a specified size
+    StackAllocator(size_t size);
+    
+    // Create a stack allocator with pre-allocated memory
+    StackAllocator(void* memory, size_t size);
+    
+    // Destructor
+    ~StackAllocator() override;
+    
+    // Allocate memory
+    void* Allocate(size_t size, size_t alignment = 0) override;
+    
+    // Free memory (must be the most recently allocated block)
+    void Free(void* ptr) override;
+    
+    // Get a marker for the current position
+    Marker GetMarker() const;
+    
+    // Free all memory up to a marker
+    void FreeToMarker(Marker marker);
+    
+    // Reset the allocator (free all memory)
+    void Reset();
+    
+    // Get the total size of allocated memory
+    size_t GetAllocatedSize() const override { return m_offset; }
+    
+    // Get the total size of the memory pool
+    size_t GetTotalSize() const override { return m_size; }
+};
+
+/**
+ * @brief Linear allocator over reserved virtual memory - grows in place up to its reservation
+ *
+ * Only the address range is reserved up front; pages are committed as the
+ * offset reaches them, so a large reservation costs no physical memory
+ * until it is used. Trim hands pages above the high-water mark back after
+ * a Reset.
+ */
+class VirtualLinearAllocator : public Allocator {
+private:
+    VirtualMemoryRange m_range;
+    size_t m_offset;
+
+public:
+    // Reserve reserveSize bytes of address space
+    explicit VirtualLinearAllocator(size_t reserveSize, const VirtualMemoryOptions& options = VirtualMemoryOptions())
+        : m_range(reserveSize, options), m_offset(0) {}
+    
+    // Allocate memory, committing pages as needed (null once the reservation is exhausted)
+    void* Allocate(size_t size, size_t alignment = 0) override { return m_range.BumpAllocate(m_offset, size, alignment); }
+    
+    // Individual frees are not supported; use Reset
+    void Free(void* /*ptr*/) override {}
+    
+    // Free all memory (pages stay committed until Trim)
+    void Reset() { m_offset = 0; }
+    
+    // Decommit pages beyond the current offset, keeping at least keepSize bytes committed
+    void Trim(size_t keepSize = 0) { m_range.Decommit(m_offset > keepSize ? m_offset : keepSize); }
+    
+    // Get the total size of allocated memory
+    size_t GetAllocatedSize() const override { return m_offset; }
+    
+    // Get the reserved size
+    size_t GetTotalSize() const override { return m_range.GetReservedSize(); }
+    
+    // Get the committed (physically backed) size
+    size_t GetCommittedSize() const { return m_range.GetCommittedSize(); }
+};
+
+/**
+ * @brief Stack allocator over reserved virtual memory - grows in place up to its reservation
+ *
+ * Each block is preceded by the offset the stack had before it, so Free of
+ * the most recent block pops exactly that block; markers unwind any number
+ * of blocks at once.
+ */
+class VirtualStackAllocator : public Allocator {
+public:
+    using Marker = StackAllocator::Marker;
+
+private:
+    VirtualMemoryRange m_range;
+    size_t m_offset;
+
+public:
+    // Reserve reserveSize bytes of address space
+    explicit VirtualStackAllocator(size_t reserveSize, const VirtualMemoryOptions& options = VirtualMemoryOptions())
+        : m_range(reserveSize, options), m_offset(0) {}
+    
+    // Allocate memory, committing pages as needed (null once the reservation is exhausted)
+    void* Allocate(size_t size, size_t alignment = 0) override {
+        alignment = alignment > alignof(size_t) ? alignment : alignof(size_t);
+        size_t offset = m_offset + sizeof(size_t);
+        uint8_t* ptr = static_cast<uint8_t*>(m_range.BumpAllocate(offset, size, alignment));
+        if (!ptr) {
+            return nullptr;
+        }
+        std::memcpy(ptr - sizeof(size_t), &m_offset, sizeof(size_t));
+        m_offset = offset;
+        return ptr;
+    }
+    
+    // Free memory (must be the most recently allocated block)
+    void Free(void* ptr) override {
+        if (ptr) {
+            std::memcpy(&m_offset, static_cast<uint8_t*>(ptr) - sizeof(size_t), sizeof(size_t));
+        }
+    }
+    
+    // Get a marker for the current position
+    Marker GetMarker() const { return Marker{m_offset, 0}; }
+    
+    // Free all memory up to a marker
+    void FreeToMarker(Marker marker) { m_offset = marker.offset; }
+    
+    // Free all memory (pages stay committed until Trim)
+    void Reset() { m_offset = 0; }
+    
+    // Decommit pages beyond the current top, keeping at least keepSize bytes committed
+    void Trim(size_t keepSize = 0) { m_range.Decommit(m_offset > keepSize ? m_offset : keepSize); }
+    
+    // Get the total size of allocated memory
+    size_t GetAllocatedSize() const override { return m_offset; }
+    
+    // Get the reserved size
+    size_t GetTotalSize() const override { return m_range.GetReservedSize(); }
+    
+    // Get the committed (physically backed) size
+    size_t GetCommittedSize() const { return m_range.GetCommittedSize(); }
+};
+
+/**
+ * @brief Occupancy of one slab allocator size class
+ */
+struct SlabClassUsage {
+    size_t blockSize;
+    size_t pageCount;
+    size_t blocksUsed;
+    size_t blocksTotal;
+};
+
+/**
+ * @brief Slab allocator - mixed-size allocations served from per-size-class pages
+ *
+ * Requests up to MAX_SMALL_SIZE bytes are rounded up to one of the size
+ * classes (powers of two and the midpoints between them, 16 B to 32 KB) and
+ * served from PAGE_SIZE pages that each hold blocks of one class, carved
+ * lazily and recycled through an intrusive free list like PoolAllocator.
+ * Pages are aligned to PAGE_SIZE with their header at the start, so Free
+ * finds a block's page and class by masking the pointer. Larger requests
+ * get their own mapping (mmap where available) with the header just before
+ * a PAGE_SIZE-aligned pointer; small blocks never start on a page boundary,
+ * which is how Free tells the two apart. Each class has its own lock, so
+ * threads only contend when allocating the same class. Every allocation is
+ * charged to the calling thread's current MemoryTag; small blocks record it
+ * in a byte per block between the page header and the first block, large
+ * ones in their header, so Free releases the tag the block was charged to.
+ */
+class SlabAllocator : public Allocator {
+public:
+    // Size of one slab page
+    static constexpr size_t PAGE_SIZE = 128 * 1024;
+    
+    // Largest request served from a size class
+    static constexpr size_t MAX_SMALL_SIZE = 32 * 1024;
+    
+    // Number of size classes
+    static constexpr size_t CLASS_COUNT = 22;
+    
+    // Alignment of every small block (blocks of classes that are multiples of 64 are 64-byte aligned)
+    static constexpr size_t MIN_ALIGNMENT = 16;
+
+private:
+    static constexpr size_t CLASS_SIZES[CLASS_COUNT] = {
+        16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768,
+        1024, 1536, 2048, 3072, 4096, 6144, 8192, 12288, 16384, 24576, 32768
+    };
+    
+    struct alignas(64) PageHeader {
+        uint32_t classIndex;
+        uint32_t usedBlocks;
+        uint32_t capacity;
+        uint32_t carvedBlocks;
+        void* freeList;
+        PageHeader* prev;
+        PageHeader* next;
+    };
+    
+    struct LargeHeader {
+        void* mapping;
+        size_t mappingSize;
+        size_t size;
+#if CHULUBME_MEMORY_TRACKING
+        MemoryTag tag;
+#endif
+    };
+    
+    struct alignas(64) SizeClass {
+        std::mutex mutex;
+        // Pages with at least one free block
+        PageHeader* partialPages = nullptr;
+        // Pages with every block in use
+        PageHeader* fullPages = nullptr;
+        // One fully free page kept to avoid releasing and re-acquiring at a boundary
+        PageHeader* cachedPage = nullptr;
+        size_t pageCount = 0;
+        size_t usedBlocks = 0;
+    };
+    
+    SizeClass m_classes[CLASS_COUNT];
+    std::atomic<size_t> m_allocatedSize;
+    std::atomic<size_t> m_reservedSize;
+    std::atomic<size_t> m_largeCount;
+    std::atomic<size_t> m_largeSize;
+    
+#if CHULUBME_MEMORY_TRACKING
+    // Bytes after a page header holding one tag per block (a multiple of 64 so blocks keep their alignment)
+    static size_t TagAreaSize(size_t classIndex) {
+        return ((PAGE_SIZE - sizeof(PageHeader)) / (CLASS_SIZES[classIndex] + 1) + 63) & ~size_t{63};
+    }
+    
+    static MemoryTag* BlockTags(PageHeader* page) { return reinterpret_cast<MemoryTag*>(page + 1); }
+#else
+    static size_t TagAreaSize(size_t) { return 0; }
+#endif
+    
+    // Offset of the first block in a page of a class
+    static size_t FirstBlockOffset(size_t classIndex) { return sizeof(PageHeader) + TagAreaSize(classIndex); }
+    
+    // Number of blocks a page of a class holds
+    static size_t BlocksPerPage(size_t classIndex) {
+        size_t blocks = (PAGE_SIZE - FirstBlockOffset(classIndex)) / CLASS_SIZES[classIndex];
+#if CHULUBME_MEMORY_TRACKING
+        blocks = blocks < TagAreaSize(classIndex) ? blocks : TagAreaSize(classIndex);
+#endif
+        return blocks;
+    }
+    
+    // Smallest class that fits size with the requested alignment, or CLASS_COUNT if none
+    static size_t ClassIndex(size_t size, size_t alignment) {
+        const size_t* it = std::lower_bound(CLASS_SIZES, CLASS_SIZES + CLASS_COUNT, size);
+        for (; it != CLASS_SIZES + CLASS_COUNT; ++it) {
+            if (*it % alignment == 0) {
+                break;
+            }
+        }
+        return static_cast<size_t>(it - CLASS_SIZES);
+    }
+    
+    static void* MapMemory(size_t size) {
+#if defined(__unix__) || defined(__APPLE__)
+        void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return memory == MAP_FAILED ? nullptr : memory;
+#else
+        return ::operator new(size, std::nothrow);
+#endif
+    }
+    
+    static void UnmapMemory(void* memory, size_t size) {
+#if defined(__unix__) || defined(__APPLE__)
+        munmap(memory, size);
+#else
+        (void)size;
+        ::operator delete(memory);
+#endif
+    }
+    
+    static void Unlink(PageHeader*& list, PageHeader* page) {
+        if (page->prev) {
+            page->prev->next = page->next;
+        } else {
+            list = page->next;
+        }
+        if (page->next) {
+            page->next->prev = page->prev;
+        }
+        page->prev = page->next = nullptr;
+    }
+    
+    static void PushFront(PageHeader*& list, PageHeader* page) {
+        page->prev = nullptr;
+        page->next = list;
+        if (list) {
+            list->prev = page;
+        }
+        list = page;
+    }
+    
+    PageHeader* AcquirePage(SizeClass& sizeClass, uint32_t classIndex) {
+        PageHeader* page = sizeClass.cachedPage;
+        if (page) {
+            sizeClass.cachedPage = nullptr;
+        } else {
+            void* memory = ::operator new(PAGE_SIZE, std::align_val_t(PAGE_SIZE), std::nothrow);
+            if (!memory) {
+                return nullptr;
+            }
+            page = new (memory) PageHeader;
+            ++sizeClass.pageCount;
+            m_reservedSize.fetch_add(PAGE_SIZE, std::memory_order_relaxed);
+        }
+        page->classIndex = classIndex;
+        page->usedBlocks = 0;
+        page->capacity = static_cast<uint32_t>(BlocksPerPage(classIndex));
+        page->carvedBlocks = 0;
+        page->freeList = nullptr;
+        page->prev = page->next = nullptr;
+        return page;
+    }
+    
+    void ReleasePage(SizeClass& sizeClass, PageHeader* page) {
+        if (!sizeClass.cachedPage) {
+            sizeClass.cachedPage = page;
+            return;
+        }
+        --sizeClass.pageCount;
+        m_reservedSize.fetch_sub(PAGE_SIZE, std::memory_order_relaxed);
+        page->~PageHeader();
+        ::operator delete(page, std::align_val_t(PAGE_SIZE));
+    }
+    
+    void* AllocateSmall(size_t classIndex) {
+        SizeClass& sizeClass = m_classes[classIndex];
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        PageHeader* page = sizeClass.partialPages;
+        if (!page) {
+            page = AcquirePage(sizeClass, static_cast<uint32_t>(classIndex));
+            if (!page) {
+                return nullptr;
+            }
+            PushFront(sizeClass.partialPages, page);
+        }
+        
+        void* block;
+        if (page->freeList) {
+            block = page->freeList;
+            page->freeList = *static_cast<void**>(block);
+        } else {
+            block = reinterpret_cast<uint8_t*>(page) + FirstBlockOffset(classIndex) + page->carvedBlocks * CLASS_SIZES[classIndex];
+            ++page->carvedBlocks;
+        }
+#if CHULUBME_MEMORY_TRACKING
+        size_t blockIndex = (static_cast<uint8_t*>(block) - reinterpret_cast<uint8_t*>(page) - FirstBlockOffset(classIndex)) / CLASS_SIZES[classIndex];
+        BlockTags(page)[blockIndex] = MemoryTracker::ChargeCurrentTag(CLASS_SIZES[classIndex]);
+#endif
+        if (++page->usedBlocks == page->capacity) {
+            Unlink(sizeClass.partialPages, page);
+            PushFront(sizeClass.fullPages, page);
+        }
+        ++sizeClass.usedBlocks;
+        m_allocatedSize.fetch_add(CLASS_SIZES[classIndex], std::memory_order_relaxed);
+        return block;
+    }
+    
+    void FreeSmall(void* ptr) {
+        PageHeader* page = reinterpret_cast<PageHeader*>(reinterpret_cast<uintptr_t>(ptr) & ~(PAGE_SIZE - 1));
+        SizeClass& sizeClass = m_classes[page->classIndex];
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+#if CHULUBME_MEMORY_TRACKING
+        size_t blockIndex = (static_cast<uint8_t*>(ptr) - reinterpret_cast<uint8_t*>(page) - FirstBlockOffset(page->classIndex)) / CLASS_SIZES[page->classIndex];
+        MemoryTracker::ReleaseCharge(BlockTags(page)[blockIndex], CLASS_SIZES[page->classIndex]);
+#endif
+        *static_cast<void**>(ptr) = page->freeList;
+        page->freeList = ptr;
+        if (page->usedBlocks-- == page->capacity) {
+            Unlink(sizeClass.fullPages, page);
+            PushFront(sizeClass.partialPages, page);
+        }
+        --sizeClass.usedBlocks;
+        m_allocatedSize.fetch_sub(CLASS_SIZES[page->classIndex], std::memory_order_relaxed);
+        if (page->usedBlocks == 0) {
+            Unlink(sizeClass.partialPages, page);
+            ReleasePage(sizeClass, page);
+        }
+    }
+    
+    void* AllocateLarge(size_t size) {
+        // Leave room for the header before a PAGE_SIZE-aligned block
+        size_t mappingSize = size + PAGE_SIZE + sizeof(LargeHeader);
+        void* mapping = MapMemory(mappingSize);
+        if (!mapping) {
+            return nullptr;
+        }
+        uintptr_t base = reinterpret_cast<uintptr_t>(mapping) + sizeof(LargeHeader);
+        uintptr_t block = (base + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+        LargeHeader* header = reinterpret_cast<LargeHeader*>(block) - 1;
+        header->mapping = mapping;
+        header->mappingSize = mappingSize;
+        header->size = size;
+#if CHULUBME_MEMORY_TRACKING
+        header->tag = MemoryTracker::ChargeCurrentTag(size);
+#endif
+        m_allocatedSize.fetch_add(size, std::memory_order_relaxed);
+        m_reservedSize.fetch_add(mappingSize, std::memory_order_relaxed);
+        m_largeCount.fetch_add(1, std::memory_order_relaxed);
+        m_largeSize.fetch_add(size, std::memory_order_relaxed);
+        return reinterpret_cast<void*>(block);
+    }
+    
+    void FreeLarge(void* ptr) {
+        LargeHeader* header = static_cast<LargeHeader*>(ptr) - 1;
+#if CHULUBME_MEMORY_TRACKING
+        MemoryTracker::ReleaseCharge(header->tag, header->size);
+#endif
+        m_allocatedSize.fetch_sub(header->size, std::memory_order_relaxed);
+        m_reservedSize.fetch_sub(header->mappingSize, std::memory_order_relaxed);
+        m_largeCount.fetch_sub(1, std::memory_order_relaxed);
+        m_largeSize.fetch_sub(header->size, std::memory_order_relaxed);
+        UnmapMemory(header->mapping, header->mappingSize);
+    }
+
+public:
+    SlabAllocator() : m_allocatedSize(0), m_reservedSize(0), m_largeCount(0), m_largeSize(0) {}
+    
+    // Destructor (releases every page; outstanding blocks become invalid)
+    ~SlabAllocator() override {
+        for (SizeClass& sizeClass : m_classes) {
+            for (PageHeader* list : {sizeClass.partialPages, sizeClass.fullPages}) {
+                for (PageHeader* page = list; page;) {
+                    PageHeader* next = page->next;
+                    ::operator delete(page, std::align_val_t(PAGE_SIZE));
+                    page = next;
+                }
+            }
+            if (sizeClass.cachedPage) {
+                ::operator delete(sizeClass.cachedPage, std::align_val_t(PAGE_SIZE));
+            }
+        }
+    }
+    
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+    
+    // Allocate memory (alignment 0 means MIN_ALIGNMENT)
+    void* Allocate(size_t size, size_t alignment = 0) override {
+        if (alignment < MIN_ALIGNMENT) {
+            alignment = MIN_ALIGNMENT;
+        }
+        size_t classIndex = alignment <= 64 && size <= MAX_SMALL_SIZE ? ClassIndex(size, alignment) : CLASS_COUNT;
+        return classIndex < CLASS_COUNT ? AllocateSmall(classIndex) : AllocateLarge(size);
+    }
+    
+    // Free memory from any thread
+    void Free(void* ptr) override {
+        if (!ptr) {
+            return;
+        }
+        if ((reinterpret_cast<uintptr_t>(ptr) & (PAGE_SIZE - 1)) == 0) {
+            FreeLarge(ptr);
+        } else {
+            FreeSmall(ptr);
+        }
+    }
+    
+    // Get the usable size of an allocation
+    size_t GetBlockSize(const void* ptr) const {
+        if ((reinterpret_cast<uintptr_t>(ptr) & (PAGE_SIZE - 1)) == 0) {
+            return (static_cast<const LargeHeader*>(ptr) - 1)->size;
+        }
+        const PageHeader* page = reinterpret_cast<const PageHeader*>(reinterpret_cast<uintptr_t>(ptr) & ~(PAGE_SIZE - 1));
+        return CLASS_SIZES[page->classIndex];
+    }
+    
+    // Get occupancy of every size class
+    std::vector<SlabClassUsage> GetClassUsage() {
+        std::vector<SlabClassUsage> usage;
+        usage.reserve(CLASS_COUNT);
+        for (size_t i = 0; i < CLASS_COUNT; ++i) {
+            SizeClass& sizeClass = m_classes[i];
+            std::lock_guard<std::mutex> lock(sizeClass.mutex);
+            usage.push_back({CLASS_SIZES[i], sizeClass.pageCount, sizeClass.usedBlocks, sizeClass.pageCount * BlocksPerPage(i)});
+        }
+        return usage;
+    }
+    
+    // Get the number of live allocations larger than MAX_SMALL_SIZE
+    size_t GetLargeAllocationCount() const { return m_largeCount.load(std::memory_order_relaxed); }
+    
+    // Get the bytes held by allocations larger than MAX_SMALL_SIZE
+    size_t GetLargeAllocatedSize() const { return m_largeSize.load(std::memory_order_relaxed); }
+    
+    // Get the total size of allocated memory (rounded up to size classes)
+    size_t GetAllocatedSize() const override { return m_allocatedSize.load(std::memory_order_relaxed); }
+    
+    // Get the total size of pages and large mappings
+    size_t GetTotalSize() const override { return m_reservedSize.load(std::memory_order_relaxed); }
+    
+    // Allocations are charged to the current tag
+    bool ChargesCurrentTag() const override { return true; }
+};
+
+/**
+ * @brief Per-thread, double-buffered frame arenas for transient allocations
+ *
+ * Every thread lazily gets two bump arenas over heap blocks. Allocations made during frame
+ * N come from arena N % 2 and stay valid until the end of frame N + 1, so
+ * data produced in one frame can still be consumed in the next. BeginFrame
+ * (called by Engine::Update at the frame boundary, and once per tick by the
+ * headless loop, where a tick is a frame) only advances a global frame
+ * counter; each thread resets its own arena the first time it
+ * allocates in a new frame. Allocation is therefore a pointer bump with no
+ * lock and no shared writes. Destructors never run, so only trivially
+ * destructible data belongs here; memory must not be used after the owning
+ * thread exits.
+ */
+class FrameArena {
+private:
+    // Heap block the arena bumps through
+    struct Block {
+        std::unique_ptr<uint8_t[]> memory;
+        size_t size;
+        size_t offset;
+        
+        explicit Block(size_t blockSize) : memory(new uint8_t[blockSize]), size(blockSize), offset(0) {}
+        
+        // Bump-allocate from the block; null if it does not fit
+        void* Allocate(size_t bytes, size_t alignment) {
+            uintptr_t base = reinterpret_cast<uintptr_t>(memory.get());
+            uintptr_t aligned = (base + offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+            size_t end = static_cast<size_t>(aligned - base) + bytes;
+            if (end > size) {
+                return nullptr;
+            }
+            offset = end;
+            return reinterpret_cast<void*>(aligned);
+        }
+    };
+    
+    struct Buffer {
+        // The first block is reused every frame; overflow blocks are merged into it on reset
+        std::vector<Block> blocks;
+        uint64_t frame = ~uint64_t{0};
+        size_t used = 0;
+    };
+    
+    struct ThreadArenas {
+        Buffer buffers[2];
+    };
+    
+    static std::atomic<uint64_t>& FrameCounter() {
+        static std::atomic<uint64_t> s_frame{0};
+        return s_frame;
+    }
+    
+    static std::atomic<size_t>& BlockSize() {
+        static std::atomic<size_t> s_blockSize{1024 * 1024};
+        return s_blockSize;
+    }
+    
+    static ThreadArenas& Local() {
+        thread_local ThreadArenas t_arenas;
+        return t_arenas;
+    }
+    
+    // Recycle a buffer for a new frame, growing its first block to last use's total so overflow stops
+    static void Recycle(Buffer& buffer, uint64_t frame) {
+        size_t capacity = BlockSize().load(std::memory_order_relaxed);
+        if (buffer.blocks.size() == 1 && buffer.blocks[0].size >= capacity) {
+            buffer.blocks[0].offset = 0;
+        } else {
+            size_t total = 0;
+            for (const Block& block : buffer.blocks) {
+                total += block.size;
+            }
+            buffer.blocks.clear();
+            buffer.blocks.emplace_back(total > capacity ? total : capacity);
+        }
+        buffer.frame = frame;
+        buffer.used = 0;
+    }
+
+public:
+    // Start a new frame; allocations from two frames ago become invalid
+    static void BeginFrame() { FrameCounter().fetch_add(1, std::memory_order_release); }
     
-    // Allocate memory of specified size with optional alignment
-    virtual void* Allocate(size_t size, size_t alignment = 0) = 0;
+    // Get the current frame number
+    static uint64_t GetFrameIndex() { return FrameCounter().load(std::memory_order_acquire); }
     
-    // Free previously allocated memory
-    virtual void Free(void* ptr) = 0;
+    // Set the initial size of each thread's arenas (takes effect as arenas are recycled)
+    static void SetBlockSize(size_t size) { BlockSize().store(size, std::memory_order_relaxed); }
     
-    // Get the total size of allocated memory
-    virtual size_t GetAllocatedSize() const = 0;
+    // Allocate memory that lives until the end of the next frame (alignment must be a power of two)
+    static void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        uint64_t frame = GetFrameIndex();
+        Buffer& buffer = Local().buffers[frame & 1];
+        if (buffer.frame != frame) {
+            Recycle(buffer, frame);
+        }
+        
+        alignment = alignment > 0 ? alignment : alignof(std::max_align_t);
+        void* ptr = buffer.blocks.back().Allocate(size, alignment);
+        if (!ptr) {
+            size_t capacity = BlockSize().load(std::memory_order_relaxed);
+            size_t needed = size + alignment;
+            buffer.blocks.emplace_back(needed > capacity ? needed : capacity);
+            ptr = buffer.blocks.back().Allocate(size, alignment);
+        }
+        buffer.used += size;
+        MemoryTracker::RecordTransient(MemoryTracker::GetCurrentTag(), size);
+        return ptr;
+    }
     
-    // Get the total size of the memory pool
-    virtual size_t GetTotalSize() const = 0;
+    // Get the bytes this thread has allocated in the current frame
+    static size_t GetThreadUsage() {
+        uint64_t frame = GetFrameIndex();
+        const Buffer& buffer = Local().buffers[frame & 1];
+        return buffer.frame == frame ? buffer.used : 0;
+    }
 };
 
+// Allocate count default-initialized objects that live until the end of the next frame
+template<typename T>
+T* FrameAlloc(size_t count = 1) {
+    static_assert(std::is_trivially_destructible<T>::value, "Frame allocations are never destroyed");
+    T* ptr = static_cast<T*>(FrameArena::Allocate(sizeof(T) * count, alignof(T)));
+    for (size_t i = 0; i < count; ++i) {
+        new (ptr + i) T;
+    }
+    return ptr;
+}
+
 /**
- * @brief Linear allocator - allocates memory linearly, can only free all memory at once
+ * @brief Per-thread scratch stacks for temporaries with nested lifetimes
+ *
+ * Each thread gets its own reserved range the first time it opens a
+ * ScratchScope, with a bump pointer as the top of the stack; scopes mark
+ * the top and rewind to it. The stack only reserves address space up front and commits
+ * pages as it is first reached, so threads that rarely need scratch memory
+ * cost next to nothing. Unlike FrameArena, memory is reclaimed as soon as
+ * the scope that allocated it closes rather than two frames later.
  */
-class LinearAllocator : public Allocator {
+class ScratchStack {
 private:
-    uint8_t* m_memory;
-    size_t m_size;
-    size_t m_offset;
-    bool m_ownsMemory;
-
-public:
-    // Create a linear allocator with a specified size
-    LinearAllocator(size_t size);
-    
-    // Create a linear allocator with pre-allocated memory
-    LinearAllocator(void* memory, size_t size);
+    struct ThreadStack {
+        std::unique_ptr<VirtualMemoryRange> range;
+        // Offset of the first free byte in range
+        size_t top = 0;
+        // Depth of the innermost open ScratchScope on this thread
+        uint32_t depth = 0;
+    };
     
-    // Destructor
-    ~LinearAllocator() override;
+    static std::atomic<size_t>& ReserveSize() {
+        static std::atomic<size_t> s_reserveSize{64 * 1024 * 1024};
+        return s_reserveSize;
+    }
     
-    // Allocate memory
-    void* Allocate(size_t size, size_t alignment = 0) override;
+    static ThreadStack& Local() {
+        thread_local ThreadStack t_stack;
+        return t_stack;
+    }
     
-    // Free all memory (individual frees are not supported)
-    void Free(void* ptr) override;
+    // Get the calling thread's stack, reserving its range on first use
+    static ThreadStack& Acquire() {
+        ThreadStack& local = Local();
+        if (!local.range) {
+            local.range.reset(new VirtualMemoryRange(ReserveSize().load(std::memory_order_relaxed)));
+        }
+        return local;
+    }
     
-    // Reset the allocator (free all memory)
-    void Reset();
+    friend class ScratchScope;
+
+public:
+    // Set the address space each thread reserves for its stack (takes effect for threads that have none yet)
+    static void SetReserveSize(size_t size) { ReserveSize().store(size, std::memory_order_relaxed); }
     
-    // Get the total size of allocated memory
-    size_t GetAllocatedSize() const override { return m_offset; }
+    // Get the bytes in use on the calling thread's stack
+    static size_t GetThreadUsage() { return Local().top; }
     
-    // Get the total size of the memory pool
-    size_t GetTotalSize() const override { return m_size; }
+    // Return the calling thread's committed pages above the current top to the OS
+    static void Trim() {
+        ThreadStack& local = Local();
+        if (local.range) {
+            local.range->Decommit(local.top);
+        }
+    }
 };
 
 /**
- * @brief Pool allocator - allocates fixed-size blocks of memory
+ * @brief RAII scope over the calling thread's scratch stack
+ *
+ * Takes a marker on construction and frees back to it on destruction, so
+ * everything allocated inside the scope is released in one step and nested
+ * scopes unwind in order. The scope is also a memory_resource: containers
+ * built on it (std::pmr::vector<T> v(&scope)) bump-allocate from the stack,
+ * and their individual deallocations are no-ops until the scope closes.
+ * Only the innermost open scope on a thread may allocate, since anything an
+ * outer scope allocated would be freed when the inner one closes. Scopes
+ * must live on the stack of the thread that opened them, and containers
+ * using one must be destroyed before it.
  */
-class PoolAllocator : public Allocator {
+class ScratchScope : public std::pmr::memory_resource {
 private:
-    uint8_t* m_memory;
-    size_t m_blockSize;
-    size_t m_blockCount;
-    size_t m_freeBlocks;
-    void* m_freeList;
-    bool m_ownsMemory;
+    ScratchStack::ThreadStack& m_stack;
+    size_t m_marker;
+    uint32_t m_depth;
 
-public:
-    // Create a pool allocator with specified block size and count
-    PoolAllocator(size_t blockSize, size_t blockCount);
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* ptr = Allocate(bytes, alignment);
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
     
-    // Create a pool allocator with pre-allocated memory
-    PoolAllocator(void* memory, size_t blockSize, size_t blockCount);
+    void do_deallocate(void*, size_t, size_t) override {}
     
-    // Destructor
-    ~PoolAllocator() override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+public:
+    // Open a scope on the calling thread's scratch stack
+    ScratchScope() : m_stack(ScratchStack::Acquire()), m_marker(m_stack.top), m_depth(++m_stack.depth) {}
     
-    // Allocate a block of memory
-    void* Allocate(size_t size, size_t alignment = 0) override;
+    // Free everything allocated since the scope opened
+    ~ScratchScope() override {
+        assert(m_stack.depth == m_depth && "ScratchScope closed out of order");
+        m_stack.top = m_marker;
+        --m_stack.depth;
+    }
     
-    // Free a block of memory
-    void Free(void* ptr) override;
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
     
-    // Get the total size of allocated memory
-    size_t GetAllocatedSize() const override { return (m_blockCount - m_freeBlocks) * m_blockSize; }
+    // Allocate memory that lives until the scope closes (null if the reservation is exhausted)
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        assert(m_stack.depth == m_depth && "Only the innermost ScratchScope may allocate");
+        return m_stack.range->BumpAllocate(m_stack.top, size, alignment);
+    }
     
-    // Get the total size of the memory pool
-    size_t GetTotalSize() const override { return m_blockCount * m_blockSize; }
+    // Allocate count default-initialized objects that live until the scope closes
+    template<typename T>
+    T* Alloc(size_t count = 1) {
+        static_assert(std::is_trivially_destructible<T>::value, "Scratch allocations are never destroyed");
+        T* ptr = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+        if (ptr) {
+            for (size_t i = 0; i < count; ++i) {
+                new (ptr + i) T;
+            }
+        }
+        return ptr;
+    }
+    
+    // Get the bytes allocated in this scope and any scopes nested in it
+    size_t GetUsage() const { return m_stack.top - m_marker; }
 };
 
 /**
- * @brief Stack allocator - allocates memory in a stack-like fashion
+ * @brief Exposes any Allocator as a std::pmr::memory_resource
+ *
+ * Lets the engine's allocators back standard containers through
+ * std::pmr::polymorphic_allocator. Failed allocations throw std::bad_alloc
+ * as the memory_resource contract requires. The wrapped allocator's rules
+ * still apply: a LinearAllocator only releases memory on Reset, a
+ * StackAllocator needs frees in reverse order, and pools only serve
+ * requests up to their block size. Allocators that charge the current
+ * MemoryTag themselves (arena, concurrent pool, slab) tag each allocation;
+ * for the others the resource charges the tag that was current when it was
+ * created, since pmr gives deallocation no other way to find it.
  */
-class StackAllocator : public Allocator {
+class AllocatorResource : public std::pmr::memory_resource {
 private:
-    struct Marker {
-        size_t offset;
-        size_t adjustment;
-    };
-    
-    uint8_t* m_memory;
-    size_t m_size;
-    size_t m_offset;
-    bool m_ownsMemory;
+    Allocator* m_allocator;
+    MemoryTag m_tag;
 
-public:
-    // Create a stack allocator with a specified size
-    StackAllocator(size_t size);
-    
-    // Create a stack allocator with pre-allocated memory
-    StackAllocator(void* memory, size_t size);
-    
-    // Destructor
-    ~StackAllocator() override;
-    
-    // Allocate memory
-    void* Allocate(size_t size, size_t alignment = 0) override;
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* ptr = m_allocator->Allocate(bytes, alignment);
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        if (!m_allocator->ChargesCurrentTag()) {
+            MemoryTracker::RecordAllocation(m_tag, bytes);
+        }
+        return ptr;
+    }
     
-    // Free memory (must be the most recently allocated block)
-    void Free(void* ptr) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t) override {
+        if (!m_allocator->ChargesCurrentTag()) {
+            MemoryTracker::RecordFree(m_tag, bytes);
+        }
+        m_allocator->Free(ptr);
+    }
     
-    // Get a marker for the current position
-    Marker GetMarker() const;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        const AllocatorResource* resource = dynamic_cast<const AllocatorResource*>(&other);
+        return resource && resource->m_allocator == m_allocator;
+    }
+
+public:
+    // Wrap an allocator (not owned; must outlive every container using the resource)
+    explicit AllocatorResource(Allocator& allocator) : m_allocator(&allocator), m_tag(MemoryTracker::GetCurrentTag()) {}
     
-    // Free all memory up to a marker
-    void FreeToMarker(Marker marker);
+    // Get the wrapped allocator
+    Allocator* GetAllocator() const { return m_allocator; }
+};
+
+/**
+ * @brief memory_resource that charges everything it allocates to a MemoryTag
+ *
+ * Forwards to an upstream resource; the sizes pmr passes back on
+ * deallocation keep the tag's live byte count exact. Upstream allocators
+ * that charge the current tag are told the bytes are already charged.
+ */
+class TaggedResource : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource* m_upstream;
+    MemoryTag m_tag;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* ptr;
+        {
+            CallerChargedScope charged;
+            ptr = m_upstream->allocate(bytes, alignment);
+        }
+        MemoryTracker::RecordAllocation(m_tag, bytes);
+        return ptr;
+    }
     
-    // Reset the allocator (free all memory)
-    void Reset();
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        MemoryTracker::RecordFree(m_tag, bytes);
+        m_upstream->deallocate(ptr, bytes, alignment);
+    }
     
-    // Get the total size of allocated memory
-    size_t GetAllocatedSize() const override { return m_offset; }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+public:
+    TaggedResource(MemoryTag tag, std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : m_upstream(upstream), m_tag(tag) {}
     
-    // Get the total size of the memory pool
-    size_t GetTotalSize() const override { return m_size; }
+    // Get the tag allocations are charged to
+    MemoryTag GetTag() const { return m_tag; }
 };
 
 /**
@@ -157,7 +1560,40 @@ public:
         Default,    // Default allocator (system malloc/free)
         Linear,     // Linear allocator
         Pool,       // Pool allocator
-        Stack       // Stack allocator
+        Stack,      // Stack allocator
+        Frame,      // Per-thread frame arenas (FrameArena); lock-free, Free is a no-op
+        Slab        // Size-class slab allocator (SlabAllocator); per-class locks instead of m_mutex
+    };
+    
+    // Number of allocator types
+    static constexpr size_t ALLOCATOR_TYPE_COUNT = 6;
+    
+    /**
+     * @brief memory_resource that allocates through one of the manager's allocator types
+     */
+    class Resource : public std::pmr::memory_resource {
+    private:
+        MemoryManager* m_manager;
+        AllocatorType m_type;
+    
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            void* ptr = m_manager->Allocate(m_type, bytes, alignment);
+            if (!ptr) {
+                throw std::bad_alloc();
+            }
+            return ptr;
+        }
+        
+        void do_deallocate(void* ptr, size_t, size_t) override { m_manager->Free(m_type, ptr); }
+        
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    
+    public:
+        Resource(MemoryManager* manager, AllocatorType type) : m_manager(manager), m_type(type) {}
+        
+        // Get the allocator type this resource allocates from
+        AllocatorType GetType() const { return m_type; }
     };
 
 private:
@@ -170,10 +1606,16 @@ private:
     // Mutex for thread safety
     std::mutex m_mutex;
     
-    // Private constructor for singleton
-    MemoryManager();
+    // memory_resource view of each allocator type, indexed by AllocatorType
+    Resource m_resources[ALLOCATOR_TYPE_COUNT] = {
+        {this, AllocatorType::Default}, {this, AllocatorType::Linear}, {this, AllocatorType::Pool},
+        {this, AllocatorType::Stack}, {this, AllocatorType::Frame}, {this, AllocatorType::Slab}
+    };
 
 public:
+    // Create a standalone memory manager (each World owns one; Instance() is the process-wide default)
+    MemoryManager();
+    
     // Get singleton instance
     static MemoryManager& Instance();
     
@@ -186,30 +1628,61 @@ public:
     // Shutdown the memory manager
     void Shutdown();
     
-    // Allocate memory using a specific allocator
+    // Allocate memory using a specific allocator (Frame bypasses the lock and the allocator map). The
+    // allocator charges the calling thread's current tag if it tracks tags (Slab and any registered
+    // arena or concurrent pool do).
     void* Allocate(AllocatorType type, size_t size, size_t alignment = 0);
     
-    // Free memory allocated with a specific allocator
+    // Free memory allocated with a specific allocator (releases the tag the allocation was charged to)
     void Free(AllocatorType type, void* ptr);
     
+    // Allocate memory and charge it to a subsystem tag instead of the current one
+    void* Allocate(AllocatorType type, size_t size, size_t alignment, MemoryTag tag) {
+        void* ptr;
+        {
+            CallerChargedScope charged;
+            ptr = Allocate(type, size, alignment);
+        }
+        if (ptr) {
+            MemoryTracker::RecordAllocation(tag, size);
+        }
+        return ptr;
+    }
+    
+    // Free memory charged to a tag by the tagged Allocate (size must match)
+    void Free(AllocatorType type, void* ptr, size_t size, MemoryTag tag) {
+        if (ptr) {
+            MemoryTracker::RecordFree(tag, size);
+            Free(type, ptr);
+        }
+    }
+    
     // Get an allocator
     Allocator* GetAllocator(AllocatorType type);
     
     // Register a custom allocator
     void RegisterAllocator(AllocatorType type, std::unique_ptr<Allocator> allocator);
     
+    // Get a memory_resource for standard containers that allocates through an allocator type
+    std::pmr::memory_resource* GetResource(AllocatorType type) { return &m_resources[static_cast<size_t>(type)]; }
+    
     // Get memory usage statistics
     struct MemoryStats {
         size_t totalAllocated;
         size_t totalReserved;
         std::unordered_map<AllocatorType, size_t> allocatorUsage;
+        
+        // Occupancy per slab size class, and slab allocations past the largest class
+        std::vector<SlabClassUsage> slabClasses;
+        size_t slabLargeAllocations;
+        size_t slabLargeSize;
     };
     
     MemoryStats GetMemoryStats() const;
 };
 
-// Smart pointer that uses a specific allocator
-template<typename T, MemoryManager::AllocatorType Type = MemoryManager::AllocatorType::Default>
+// Smart pointer that uses a specific allocator and charges its object to a memory tag
+template<typename T, MemoryManager::AllocatorType Type = MemoryManager::AllocatorType::Default, MemoryTag Tag = MemoryTag::Untagged>
 class AllocatedPtr {
 private:
     T* m_ptr;
@@ -221,14 +1694,14 @@ public:
     // Constructor with initialization
     template<typename... Args>
     AllocatedPtr(Args&&... args) {
-        m_ptr = new (MemoryManager::Instance().Allocate(Type, sizeof(T))) T(std::forward<Args>(args)...);
+        m_ptr = new (MemoryManager::Instance().Allocate(Type, sizeof(T), alignof(T), Tag)) T(std::forward<Args>(args)...);
     }
     
     // Destructor
     ~AllocatedPtr() {
         if (m_ptr) {
             m_ptr->~T();
-            MemoryManager::Instance().Free(Type, m_ptr);
+            MemoryManager::Instance().Free(Type, m_ptr, sizeof(T), Tag);
         }
     }
     
@@ -242,7 +1715,7 @@ public:
         if (this != &other) {
             if (m_ptr) {
                 m_ptr->~T();
-                MemoryManager::Instance().Free(Type, m_ptr);
+                MemoryManager::Instance().Free(Type, m_ptr, sizeof(T), Tag);
             }
             m_ptr = other.m_ptr;
             other.m_ptr = nullptr;
@@ -268,7 +1741,7 @@ public:
     void Reset() {
         if (m_ptr) {
             m_ptr->~T();
-            MemoryManager::Instance().Free(Type, m_ptr);
+            MemoryManager::Instance().Free(Type, m_ptr, sizeof(T), Tag);
             m_ptr = nullptr;
         }
     }
@@ -277,15 +1750,268 @@ public:
     template<typename... Args>
     void Reset(Args&&... args) {
         Reset();
-        m_ptr = new (MemoryManager::Instance().Allocate(Type, sizeof(T))) T(std::forward<Args>(args)...);
+        m_ptr = new (MemoryManager::Instance().Allocate(Type, sizeof(T), alignof(T), Tag)) T(std::forward<Args>(args)...);
     }
 };
 
 // Factory function to create an allocated pointer
-template<typename T, MemoryManager::AllocatorType Type = MemoryManager::AllocatorType::Default, typename... Args>
-AllocatedPtr<T, Type> MakeAllocated(Args&&... args) {
-    return AllocatedPtr<T, Type>(std::forward<Args>(args)...);
+template<typename T, MemoryManager::AllocatorType Type = MemoryManager::AllocatorType::Default,
+         MemoryTag Tag = MemoryTag::Untagged, typename... Args>
+AllocatedPtr<T, Type, Tag> MakeAllocated(Args&&... args) {
+    return AllocatedPtr<T, Type, Tag>(std::forward<Args>(args)...);
+}
+
+// Smart pointer that remembers the allocator it came from, so construction and destruction
+// go straight to that allocator instead of through MemoryManager
+template<typename T>
+class AllocatorPtr {
+private:
+    T* m_ptr;
+    Allocator* m_allocator;
+    
+    void Destroy() {
+        if (m_ptr) {
+            m_ptr->~T();
+            m_allocator->Free(m_ptr);
+            m_ptr = nullptr;
+        }
+    }
+
+public:
+    // Constructor
+    AllocatorPtr() : m_ptr(nullptr), m_allocator(nullptr) {}
+    
+    // Construct a T in memory from allocator (empty if the allocator is exhausted)
+    template<typename... Args>
+    explicit AllocatorPtr(Allocator& allocator, Args&&... args) : m_ptr(nullptr), m_allocator(&allocator) {
+        void* memory = allocator.Allocate(sizeof(T), alignof(T));
+        if (memory) {
+            m_ptr = new (memory) T(std::forward<Args>(args)...);
+        }
+    }
+    
+    // Destructor
+    ~AllocatorPtr() { Destroy(); }
+    
+    // Move constructor
+    AllocatorPtr(AllocatorPtr&& other) noexcept : m_ptr(other.m_ptr), m_allocator(other.m_allocator) {
+        other.m_ptr = nullptr;
+    }
+    
+    // Move assignment
+    AllocatorPtr& operator=(AllocatorPtr&& other) noexcept {
+        if (this != &other) {
+            Destroy();
+            m_ptr = other.m_ptr;
+            m_allocator = other.m_allocator;
+            other.m_ptr = nullptr;
+        }
+        return *this;
+    }
+    
+    // Disable copy constructor and assignment
+    AllocatorPtr(const AllocatorPtr&) = delete;
+    AllocatorPtr& operator=(const AllocatorPtr&) = delete;
+    
+    // Dereference operators
+    T* operator->() const { return m_ptr; }
+    T& operator*() const { return *m_ptr; }
+    
+    // Get the raw pointer
+    T* Get() const { return m_ptr; }
+    
+    // Get the allocator the object lives in
+    Allocator* GetAllocator() const { return m_allocator; }
+    
+    // Check if pointer is valid
+    explicit operator bool() const { return m_ptr != nullptr; }
+    
+    // Destroy the object and return its memory to the allocator
+    void Reset() { Destroy(); }
+};
+
+// Factory function to create an allocator pointer
+template<typename T, typename... Args>
+AllocatorPtr<T> MakeAllocatorPtr(Allocator& allocator, Args&&... args) {
+    return AllocatorPtr<T>(allocator, std::forward<Args>(args)...);
 }
 
+/**
+ * @brief Typed object pool with generational handles
+ *
+ * Objects are placement-constructed into cache-line-aligned slots so two
+ * pooled objects never share a line. Slots live in fixed pages that are
+ * never moved, so pointers stay valid until their object is destroyed.
+ * Handles carry a generation like Entity: a handle to a destroyed object
+ * resolves to nullptr even after its slot has been reused. Free slots form
+ * an intrusive list, so Create and Destroy are O(1) with no lock; a pool
+ * belongs to one thread or world at a time.
+ */
+template<typename T>
+class ObjectPool {
+public:
+    // Generational reference to a pooled object
+    struct Handle {
+        uint32_t index;
+        uint32_t generation;
+        
+        constexpr Handle() : index(0), generation(0) {}
+        constexpr Handle(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
+        
+        // Check if the handle was ever assigned (it may still be stale)
+        constexpr bool IsValid() const { return generation != 0; }
+        
+        constexpr bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+        constexpr bool operator!=(const Handle& other) const { return !(*this == other); }
+    };
+    
+    // Slots per page
+    static constexpr uint32_t PAGE_SLOTS = 64;
+
+private:
+    static constexpr size_t SLOT_ALIGNMENT = alignof(T) > 64 ? alignof(T) : 64;
+    static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFFu;
+    
+    struct alignas(SLOT_ALIGNMENT) Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        uint32_t generation;
+        // Next free slot while free, INVALID_SLOT while alive
+        uint32_t nextFree;
+        bool alive;
+        
+        T* Get() { return reinterpret_cast<T*>(storage); }
+    };
+    
+    struct Page {
+        Slot slots[PAGE_SLOTS];
+    };
+    
+    // Page memory source, or null for the global heap
+    Allocator* m_allocator;
+    std::vector<Page*> m_pages;
+    uint32_t m_freeHead;
+    size_t m_count;
+    
+    Slot& SlotAt(uint32_t index) const { return m_pages[index / PAGE_SLOTS]->slots[index % PAGE_SLOTS]; }
+    
+    bool AddPage() {
+        void* memory = m_allocator ? m_allocator->Allocate(sizeof(Page), alignof(Page))
+                                   : ::operator new(sizeof(Page), std::align_val_t(alignof(Page)), std::nothrow);
+        if (!memory) {
+            return false;
+        }
+        Page* page = static_cast<Page*>(memory);
+        uint32_t first = static_cast<uint32_t>(m_pages.size()) * PAGE_SLOTS;
+        m_pages.push_back(page);
+        // Thread the new slots onto the free list in index order
+        for (uint32_t i = PAGE_SLOTS; i-- > 0;) {
+            Slot* slot = new (&page->slots[i]) Slot;
+            slot->generation = 1;
+            slot->alive = false;
+            slot->nextFree = m_freeHead;
+            m_freeHead = first + i;
+        }
+        return true;
+    }
+    
+    void FreePage(Page* page) {
+        if (m_allocator) {
+            m_allocator->Free(page);
+        } else {
+            ::operator delete(page, std::align_val_t(alignof(Page)));
+        }
+    }
+
+public:
+    // Create a pool; pages come from allocator if given, and initialCapacity slots are reserved up front
+    explicit ObjectPool(size_t initialCapacity = 0, Allocator* allocator = nullptr)
+        : m_allocator(allocator), m_freeHead(INVALID_SLOT), m_count(0) {
+        while (m_pages.size() * PAGE_SLOTS < initialCapacity && AddPage()) {
+        }
+    }
+    
+    // Destructor (destroys every live object)
+    ~ObjectPool() {
+        Clear();
+        for (Page* page : m_pages) {
+            FreePage(page);
+        }
+    }
+    
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+    
+    // Construct an object in a free slot; returns an invalid handle if memory runs out
+    template<typename... Args>
+    Handle Create(Args&&... args) {
+        if (m_freeHead == INVALID_SLOT && !AddPage()) {
+            return Handle();
+        }
+        uint32_t index = m_freeHead;
+        Slot& slot = SlotAt(index);
+        new (slot.storage) T(std::forward<Args>(args)...);
+        m_freeHead = slot.nextFree;
+        slot.nextFree = INVALID_SLOT;
+        slot.alive = true;
+        ++m_count;
+        return Handle(index, slot.generation);
+    }
+    
+    // Destroy an object; stale handles are ignored
+    void Destroy(Handle handle) {
+        if (!IsAlive(handle)) {
+            return;
+        }
+        Slot& slot = SlotAt(handle.index);
+        slot.Get()->~T();
+        slot.alive = false;
+        if (++slot.generation == 0) {
+            slot.generation = 1;
+        }
+        slot.nextFree = m_freeHead;
+        m_freeHead = handle.index;
+        --m_count;
+    }
+    
+    // Check if a handle refers to a live object
+    bool IsAlive(Handle handle) const {
+        if (handle.index >= m_pages.size() * PAGE_SLOTS) {
+            return false;
+        }
+        const Slot& slot = SlotAt(handle.index);
+        return slot.alive && slot.generation == handle.generation;
+    }
+    
+    // Get the object a handle refers to, or nullptr if it was destroyed
+    T* Get(Handle handle) const { return IsAlive(handle) ? SlotAt(handle.index).Get() : nullptr; }
+    
+    // Call fn(Handle, T&) for every live object in slot order
+    template<typename Fn>
+    void ForEach(Fn&& fn) {
+        for (uint32_t index = 0; index < m_pages.size() * PAGE_SLOTS; ++index) {
+            Slot& slot = SlotAt(index);
+            if (slot.alive) {
+                fn(Handle(index, slot.generation), *slot.Get());
+            }
+        }
+    }
+    
+    // Destroy every live object, keeping the pages
+    void Clear() {
+        for (uint32_t index = 0; index < m_pages.size() * PAGE_SLOTS; ++index) {
+            Slot& slot = SlotAt(index);
+            if (slot.alive) {
+                Destroy(Handle(index, slot.generation));
+            }
+        }
+    }
+    
+    // Get the number of live objects
+    size_t GetCount() const { return m_count; }
+    
+    // Get the number of slots
+    size_t GetCapacity() const { return m_pages.size() * PAGE_SLOTS; }
+};
+
 } // namespace CHULUBME
 
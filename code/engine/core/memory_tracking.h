@@ -0,0 +1,311 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Per-subsystem allocation accounting; compiled out of shipping builds unless set explicitly
+#ifndef CHULUBME_MEMORY_TRACKING
+#if defined(CHULUBME_SHIPPING)
+#define CHULUBME_MEMORY_TRACKING 0
+#else
+#define CHULUBME_MEMORY_TRACKING 1
+#endif
+#endif
+
+namespace CHULUBME {
+
+/**
+ * @brief Subsystem an allocation is charged to
+ */
+enum class MemoryTag : uint8_t {
+    Untagged,
+    Rendering,
+    Gameplay,
+    Blockchain,
+    Assets,
+    Network,
+    Count
+};
+
+// Get the display name of a tag
+inline const char* GetMemoryTagName(MemoryTag tag) {
+    static const char* const s_names[] = {"Untagged", "Rendering", "Gameplay", "Blockchain", "Assets", "Network"};
+    return tag < MemoryTag::Count ? s_names[static_cast<size_t>(tag)] : "Invalid";
+}
+
+/**
+ * @brief Accounting of one tag at the time of a snapshot
+ */
+struct MemoryTagStats {
+    // Bytes currently live and the most that were ever live at once
+    size_t currentBytes;
+    size_t peakBytes;
+
+    // Running totals since startup (transient frame allocations count here but not as live bytes)
+    uint64_t totalAllocatedBytes;
+    uint64_t allocationCount;
+    uint64_t freeCount;
+
+    // Averages since the previous snapshot
+    double bytesPerSecond;
+    double allocationsPerSecond;
+
+    // Budget in bytes (0 = none)
+    size_t budgetBytes;
+};
+
+/**
+ * @brief Per-tag statistics captured by MemoryTracker::TakeSnapshot
+ */
+struct MemorySnapshot {
+    MemoryTagStats tags[static_cast<size_t>(MemoryTag::Count)];
+
+    // Seconds covered by the rates
+    double intervalSeconds;
+
+    // Format one line per tag, e.g. for a per-frame log or a debug overlay
+    std::string Format() const {
+        std::string text;
+        char line[192];
+        for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); ++i) {
+            const MemoryTagStats& stats = tags[i];
+            std::snprintf(line, sizeof(line), "%-10s cur %10zu peak %10zu budget %10zu  %12.0f B/s %9.0f allocs/s\n",
+                          GetMemoryTagName(static_cast<MemoryTag>(i)), stats.currentBytes, stats.peakBytes,
+                          stats.budgetBytes, stats.bytesPerSecond, stats.allocationsPerSecond);
+            text += line;
+        }
+        return text;
+    }
+};
+
+/**
+ * @brief Process-wide, lock-free allocation accounting per MemoryTag
+ *
+ * Allocation paths report bytes against a tag: explicitly (tagged
+ * AllocatedPtr, TaggedResource, the tagged MemoryManager calls) or through
+ * the calling thread's current tag (MemoryTagScope), which the arena,
+ * concurrent pool and slab allocators charge on every allocation and
+ * release against the same tag when the memory is freed. Explicit callers
+ * hold a CallerChargedScope around the allocator so the bytes are not
+ * counted twice. Counters are relaxed atomics on their own cache line per
+ * tag. When a tag's live bytes cross its budget the budget callback runs
+ * once, on the allocating thread; it runs again only after usage has dropped
+ * back under the budget. With CHULUBME_MEMORY_TRACKING set to 0 every
+ * function is an empty inline and snapshots are all zero.
+ */
+class MemoryTracker {
+public:
+    // Called when a tag's live bytes go over its budget
+    using BudgetCallback = void (*)(MemoryTag tag, size_t currentBytes, size_t budgetBytes, void* userData);
+
+#if CHULUBME_MEMORY_TRACKING
+private:
+    struct alignas(64) TagCounters {
+        std::atomic<size_t> currentBytes{0};
+        std::atomic<size_t> peakBytes{0};
+        std::atomic<uint64_t> totalAllocatedBytes{0};
+        std::atomic<uint64_t> allocationCount{0};
+        std::atomic<uint64_t> freeCount{0};
+        std::atomic<size_t> budgetBytes{0};
+    };
+
+    struct State {
+        TagCounters tags[static_cast<size_t>(MemoryTag::Count)];
+        std::atomic<BudgetCallback> callback{nullptr};
+        std::atomic<void*> callbackUserData{nullptr};
+
+        // Totals at the previous snapshot, for rates (only touched by TakeSnapshot)
+        uint64_t lastBytes[static_cast<size_t>(MemoryTag::Count)] = {};
+        uint64_t lastCount[static_cast<size_t>(MemoryTag::Count)] = {};
+        std::chrono::steady_clock::time_point lastSnapshot = std::chrono::steady_clock::now();
+    };
+
+    static State& GetState() {
+        static State s_state;
+        return s_state;
+    }
+
+    static MemoryTag& CurrentTagRef() {
+        thread_local MemoryTag t_tag = MemoryTag::Untagged;
+        return t_tag;
+    }
+
+    static TagCounters& Counters(MemoryTag tag) { return GetState().tags[static_cast<size_t>(tag)]; }
+
+    static bool& CallerChargesRef() {
+        thread_local bool t_callerCharges = false;
+        return t_callerCharges;
+    }
+
+public:
+    // Charge a live allocation to a tag
+    static void RecordAllocation(MemoryTag tag, size_t size) {
+        TagCounters& counters = Counters(tag);
+        size_t current = counters.currentBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        counters.totalAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        counters.allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+        size_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+        while (current > peak && !counters.peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+        }
+
+        // Only the allocation that crosses the budget reports it
+        size_t budget = counters.budgetBytes.load(std::memory_order_relaxed);
+        if (budget != 0 && current > budget && current - size <= budget) {
+            State& state = GetState();
+            if (BudgetCallback callback = state.callback.load(std::memory_order_acquire)) {
+                callback(tag, current, budget, state.callbackUserData.load(std::memory_order_relaxed));
+            }
+        }
+    }
+
+    // Release a live allocation charged to a tag
+    static void RecordFree(MemoryTag tag, size_t size) {
+        TagCounters& counters = Counters(tag);
+        counters.currentBytes.fetch_sub(size, std::memory_order_relaxed);
+        counters.freeCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Charge a transient allocation that is reclaimed in bulk (frame arenas): counts toward rates only
+    static void RecordTransient(MemoryTag tag, size_t size) {
+        TagCounters& counters = Counters(tag);
+        counters.totalAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        counters.allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Charge an allocation to the calling thread's current tag; returns the tag to hand back to
+    // ReleaseCharge, or MemoryTag::Count if an explicitly tagged caller is charging it instead
+    static MemoryTag ChargeCurrentTag(size_t size) {
+        if (CallerChargesRef()) {
+            return MemoryTag::Count;
+        }
+        MemoryTag tag = CurrentTagRef();
+        RecordAllocation(tag, size);
+        return tag;
+    }
+
+    // Release bytes charged by ChargeCurrentTag
+    static void ReleaseCharge(MemoryTag tag, size_t size) {
+        if (tag != MemoryTag::Count) {
+            RecordFree(tag, size);
+        }
+    }
+
+    // Get the calling thread's current tag
+    static MemoryTag GetCurrentTag() { return CurrentTagRef(); }
+
+    // Check whether an explicitly tagged caller is charging the calling thread's allocations
+    static bool IsCallerCharging() { return CallerChargesRef(); }
+
+    // Mark the calling thread's allocations as charged by the caller (prefer CallerChargedScope)
+    static void SetCallerCharging(bool charging) { CallerChargesRef() = charging; }
+
+    // Set the calling thread's current tag (prefer MemoryTagScope)
+    static void SetCurrentTag(MemoryTag tag) { CurrentTagRef() = tag; }
+
+    // Set a tag's budget in bytes (0 removes it)
+    static void SetBudget(MemoryTag tag, size_t bytes) { Counters(tag).budgetBytes.store(bytes, std::memory_order_relaxed); }
+
+    // Set the function called when a budget is exceeded (null removes it)
+    static void SetBudgetCallback(BudgetCallback callback, void* userData = nullptr) {
+        State& state = GetState();
+        state.callbackUserData.store(userData, std::memory_order_relaxed);
+        state.callback.store(callback, std::memory_order_release);
+    }
+
+    // Get a tag's live bytes
+    static size_t GetCurrentBytes(MemoryTag tag) { return Counters(tag).currentBytes.load(std::memory_order_relaxed); }
+
+    // Get a tag's high-water mark
+    static size_t GetPeakBytes(MemoryTag tag) { return Counters(tag).peakBytes.load(std::memory_order_relaxed); }
+
+    // Reset every high-water mark to the current usage
+    static void ResetPeaks() {
+        for (TagCounters& counters : GetState().tags) {
+            counters.peakBytes.store(counters.currentBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    }
+
+    // Capture every tag's counters; rates cover the time since the previous snapshot.
+    // Call from one thread (e.g. once per frame).
+    static MemorySnapshot TakeSnapshot() {
+        State& state = GetState();
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - state.lastSnapshot).count();
+        state.lastSnapshot = now;
+
+        MemorySnapshot snapshot;
+        snapshot.intervalSeconds = seconds;
+        for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); ++i) {
+            TagCounters& counters = state.tags[i];
+            MemoryTagStats& stats = snapshot.tags[i];
+            stats.currentBytes = counters.currentBytes.load(std::memory_order_relaxed);
+            stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+            stats.totalAllocatedBytes = counters.totalAllocatedBytes.load(std::memory_order_relaxed);
+            stats.allocationCount = counters.allocationCount.load(std::memory_order_relaxed);
+            stats.freeCount = counters.freeCount.load(std::memory_order_relaxed);
+            stats.budgetBytes = counters.budgetBytes.load(std::memory_order_relaxed);
+            stats.bytesPerSecond = seconds > 0.0 ? (stats.totalAllocatedBytes - state.lastBytes[i]) / seconds : 0.0;
+            stats.allocationsPerSecond = seconds > 0.0 ? (stats.allocationCount - state.lastCount[i]) / seconds : 0.0;
+            state.lastBytes[i] = stats.totalAllocatedBytes;
+            state.lastCount[i] = stats.allocationCount;
+        }
+        return snapshot;
+    }
+#else
+public:
+    static void RecordAllocation(MemoryTag, size_t) {}
+    static void RecordFree(MemoryTag, size_t) {}
+    static void RecordTransient(MemoryTag, size_t) {}
+    static MemoryTag ChargeCurrentTag(size_t) { return MemoryTag::Count; }
+    static void ReleaseCharge(MemoryTag, size_t) {}
+    static MemoryTag GetCurrentTag() { return MemoryTag::Untagged; }
+    static bool IsCallerCharging() { return false; }
+    static void SetCallerCharging(bool) {}
+    static void SetCurrentTag(MemoryTag) {}
+    static void SetBudget(MemoryTag, size_t) {}
+    static void SetBudgetCallback(BudgetCallback, void* = nullptr) {}
+    static size_t GetCurrentBytes(MemoryTag) { return 0; }
+    static size_t GetPeakBytes(MemoryTag) { return 0; }
+    static void ResetPeaks() {}
+    static MemorySnapshot TakeSnapshot() { return MemorySnapshot{}; }
+#endif
+};
+
+/**
+ * @brief Sets the calling thread's current memory tag for its lifetime
+ */
+class MemoryTagScope {
+private:
+    MemoryTag m_previous;
+
+public:
+    explicit MemoryTagScope(MemoryTag tag) : m_previous(MemoryTracker::GetCurrentTag()) { MemoryTracker::SetCurrentTag(tag); }
+    ~MemoryTagScope() { MemoryTracker::SetCurrentTag(m_previous); }
+
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+};
+
+/**
+ * @brief Tells allocators that charge the current tag to leave the calling thread's allocations alone for its lifetime
+ *
+ * Held by explicitly tagged paths around the allocator they forward to.
+ */
+class CallerChargedScope {
+private:
+    bool m_previous;
+
+public:
+    CallerChargedScope() : m_previous(MemoryTracker::IsCallerCharging()) { MemoryTracker::SetCallerCharging(true); }
+    ~CallerChargedScope() { MemoryTracker::SetCallerCharging(m_previous); }
+
+    CallerChargedScope(const CallerChargedScope&) = delete;
+    CallerChargedScope& operator=(const CallerChargedScope&) = delete;
+};
+
+} // namespace CHULUBME
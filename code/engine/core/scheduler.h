@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ecs.h"
+#include "job_system.h"
+
+namespace CHULUBME {
+
+/**
+ * @brief Runs an entity manager's systems in parallel where their declared component access allows
+ *
+ * Each Run builds a dependency graph over the registered systems: a system
+ * depends on every earlier-registered system it conflicts with (one writes a
+ * component the other reads or writes, or either one did not declare its
+ * access). Systems whose dependencies have finished are dispatched to the
+ * job system, and the calling thread helps until the whole graph is done.
+ * Registration order is therefore preserved for conflicting systems.
+ */
+class SystemScheduler {
+public:
+    // Which system entry point to run
+    enum class Phase {
+        Update,
+        FixedUpdate
+    };
+
+private:
+    struct Node {
+        System* system;
+        std::vector<uint32_t> dependents;
+        uint32_t dependencyCount;
+    };
+
+    EntityManager* m_entityManager;
+    JobSystem* m_jobSystem;
+
+    // Dependency graph, rebuilt every Run (vectors keep their capacity)
+    std::vector<Node> m_nodes;
+
+    // Unfinished dependencies per node for the current Run
+    std::unique_ptr<std::atomic<uint32_t>[]> m_pending;
+    size_t m_pendingCapacity;
+
+    // Outstanding system jobs of the current Run
+    JobCounter m_counter;
+
+    // Arguments of the current Run
+    Phase m_phase;
+    float m_deltaTime;
+
+    void Build() {
+        const std::vector<std::unique_ptr<System>>& systems = m_entityManager->GetSystems();
+        m_nodes.resize(systems.size());
+        for (size_t i = 0; i < systems.size(); ++i) {
+            m_nodes[i].system = systems[i].get();
+            m_nodes[i].dependents.clear();
+            m_nodes[i].dependencyCount = 0;
+        }
+        for (size_t later = 1; later < m_nodes.size(); ++later) {
+            for (size_t earlier = 0; earlier < later; ++earlier) {
+                if (m_nodes[later].system->ConflictsWith(*m_nodes[earlier].system)) {
+                    m_nodes[earlier].dependents.push_back(static_cast<uint32_t>(later));
+                    ++m_nodes[later].dependencyCount;
+                }
+            }
+        }
+
+        if (m_pendingCapacity < m_nodes.size()) {
+            m_pending.reset(new std::atomic<uint32_t>[m_nodes.size()]);
+            m_pendingCapacity = m_nodes.size();
+        }
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            m_pending[i].store(m_nodes[i].dependencyCount, std::memory_order_relaxed);
+        }
+    }
+
+    // Dependents are dispatched from inside their last dependency's job, before that job
+    // releases the counter, so the counter only reaches zero once the whole graph has run
+    void Dispatch(uint32_t index) {
+        m_jobSystem->Run([this, index] { Execute(index); }, &m_counter);
+    }
+
+    void Execute(uint32_t index) {
+        Node& node = m_nodes[index];
+        m_entityManager->RunSystem(*node.system, m_phase == Phase::FixedUpdate, m_deltaTime);
+
+        for (uint32_t dependent : node.dependents) {
+            if (m_pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                Dispatch(dependent);
+            }
+        }
+    }
+
+public:
+    SystemScheduler(EntityManager* manager, JobSystem* jobSystem)
+        : m_entityManager(manager), m_jobSystem(jobSystem), m_pendingCapacity(0),
+          m_phase(Phase::Update), m_deltaTime(0.0f) {}
+
+    SystemScheduler(const SystemScheduler&) = delete;
+    SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+    // Run one phase of every system and return once all of them have finished.
+    // Systems must not make structural changes to the entity manager while running in parallel.
+    void Run(Phase phase, float deltaTime) {
+        if (!m_jobSystem) {
+            if (phase == Phase::Update) {
+                m_entityManager->Update(deltaTime);
+            } else {
+                m_entityManager->FixedUpdate(deltaTime);
+            }
+            return;
+        }
+
+        Build();
+        if (m_nodes.empty()) {
+            return;
+        }
+        m_phase = phase;
+        m_deltaTime = deltaTime;
+
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            if (m_nodes[i].dependencyCount == 0) {
+                Dispatch(static_cast<uint32_t>(i));
+            }
+        }
+        m_jobSystem->Wait(m_counter);
+    }
+};
+
+} // namespace CHULUBME
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace CHULUBME {
+
+/**
+ * @brief Dense index for the calling thread, recycled when the thread exits
+ */
+class ThreadSlot {
+private:
+    struct Registry {
+        std::mutex mutex;
+        std::vector<uint32_t> freeSlots;
+        uint32_t nextSlot = 0;
+    };
+
+    static Registry& GetRegistry() {
+        static Registry s_registry;
+        return s_registry;
+    }
+
+    struct Holder {
+        uint32_t slot;
+
+        Holder() {
+            Registry& registry = GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            if (!registry.freeSlots.empty()) {
+                slot = registry.freeSlots.back();
+                registry.freeSlots.pop_back();
+            } else {
+                slot = registry.nextSlot++;
+            }
+        }
+
+        ~Holder() {
+            Registry& registry = GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.freeSlots.push_back(slot);
+        }
+    };
+
+public:
+    // Maximum number of threads alive at the same time
+    static constexpr uint32_t MAX_SLOTS = 256;
+
+    // Get the calling thread's slot
+    static uint32_t Current() {
+        static thread_local Holder s_holder;
+        assert(s_holder.slot < MAX_SLOTS && "Too many threads");
+        return s_holder.slot;
+    }
+};
+
+} // namespace CHULUBME
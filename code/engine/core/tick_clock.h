@@ -0,0 +1,190 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <ctime>
+#include <sys/prctl.h>
+#endif
+
+namespace CHULUBME {
+
+/**
+ * @brief Rolling statistics of simulation tick durations
+ *
+ * Tick times are bucketed into a fixed histogram (0.05 ms buckets up to
+ * 50 ms) so percentiles can be read without storing samples; recording a
+ * tick never allocates.
+ */
+class TickStatistics {
+public:
+    // Width of one histogram bucket in microseconds
+    static constexpr uint32_t BUCKET_WIDTH_US = 50;
+
+    // Number of histogram buckets; the last one also collects every longer tick
+    static constexpr uint32_t BUCKET_COUNT = 1000;
+
+private:
+    uint64_t m_tickCount;
+    uint64_t m_overrunCount;
+    uint64_t m_totalMicroseconds;
+    uint64_t m_minMicroseconds;
+    uint64_t m_maxMicroseconds;
+    uint64_t m_lastMicroseconds;
+    uint32_t m_histogram[BUCKET_COUNT];
+
+public:
+    TickStatistics() { Reset(); }
+
+    // Record one tick's work time; overran is set if the tick missed its deadline
+    void Record(std::chrono::nanoseconds duration, bool overran) {
+        uint64_t us = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0)) / 1000;
+        ++m_tickCount;
+        m_overrunCount += overran ? 1 : 0;
+        m_totalMicroseconds += us;
+        m_minMicroseconds = std::min(m_minMicroseconds, us);
+        m_maxMicroseconds = std::max(m_maxMicroseconds, us);
+        m_lastMicroseconds = us;
+        ++m_histogram[std::min<uint64_t>(us / BUCKET_WIDTH_US, BUCKET_COUNT - 1)];
+    }
+
+    // Clear every sample
+    void Reset() {
+        m_tickCount = 0;
+        m_overrunCount = 0;
+        m_totalMicroseconds = 0;
+        m_minMicroseconds = std::numeric_limits<uint64_t>::max();
+        m_maxMicroseconds = 0;
+        m_lastMicroseconds = 0;
+        std::fill(m_histogram, m_histogram + BUCKET_COUNT, 0u);
+    }
+
+    // Get the number of recorded ticks
+    uint64_t GetTickCount() const { return m_tickCount; }
+
+    // Get the number of ticks that finished after their deadline
+    uint64_t GetOverrunCount() const { return m_overrunCount; }
+
+    // Get the work time of the last tick in milliseconds
+    double GetLastMs() const { return m_lastMicroseconds / 1000.0; }
+
+    // Get the shortest tick in milliseconds
+    double GetMinMs() const { return m_tickCount ? m_minMicroseconds / 1000.0 : 0.0; }
+
+    // Get the longest tick in milliseconds
+    double GetMaxMs() const { return m_maxMicroseconds / 1000.0; }
+
+    // Get the mean tick in milliseconds
+    double GetAverageMs() const {
+        return m_tickCount ? static_cast<double>(m_totalMicroseconds) / m_tickCount / 1000.0 : 0.0;
+    }
+
+    // Get the upper edge of the bucket holding the given percentile (0-100) in milliseconds
+    double GetPercentileMs(double percentile) const {
+        if (m_tickCount == 0) {
+            return 0.0;
+        }
+        uint64_t target = static_cast<uint64_t>(m_tickCount * std::min(std::max(percentile, 0.0), 100.0) / 100.0);
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += m_histogram[i];
+            if (seen > target || seen == m_tickCount) {
+                return std::min<uint64_t>((i + 1) * BUCKET_WIDTH_US, m_maxMicroseconds) / 1000.0;
+            }
+        }
+        return GetMaxMs();
+    }
+};
+
+/**
+ * @brief Paces a fixed-rate loop by sleeping until absolute tick deadlines
+ *
+ * Deadlines advance by whole tick periods from the start time, so sleep
+ * overshoot does not accumulate as drift. The wait is a single blocking
+ * sleep (clock_nanosleep with TIMER_ABSTIME on Linux, with the thread's
+ * timer slack reduced), never a spin, so idle servers use no CPU between
+ * ticks.
+ */
+class TickClock {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    Clock::duration m_period;
+    Clock::time_point m_nextDeadline;
+    uint64_t m_skippedTicks;
+
+    static void SleepUntil(Clock::time_point deadline) {
+#if defined(__linux__)
+        // steady_clock is CLOCK_MONOTONIC on Linux, so its epoch matches clock_nanosleep's
+        std::chrono::nanoseconds sinceEpoch = deadline.time_since_epoch();
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(sinceEpoch.count() / 1000000000);
+        ts.tv_nsec = static_cast<long>(sinceEpoch.count() % 1000000000);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+        }
+#else
+        std::this_thread::sleep_until(deadline);
+#endif
+    }
+
+public:
+    // Create a clock ticking at the given rate in Hz
+    explicit TickClock(uint32_t tickRate = 30) : m_skippedTicks(0) {
+        SetTickRate(tickRate);
+        m_nextDeadline = Clock::now() + m_period;
+    }
+
+    // Set the tick rate in Hz (takes effect from the next deadline)
+    void SetTickRate(uint32_t tickRate) {
+        m_period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::nanoseconds(1000000000 / std::max<uint32_t>(tickRate, 1)));
+    }
+
+    // Get the tick period
+    Clock::duration GetPeriod() const { return m_period; }
+
+    // Get the tick period in seconds
+    float GetPeriodSeconds() const { return std::chrono::duration<float>(m_period).count(); }
+
+    // Start counting deadlines from now; call from the thread that runs the loop
+    void Restart() {
+#if defined(__linux__)
+        // Default timer slack (50 us) would make every wakeup late by up to that much
+        prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+#endif
+        m_nextDeadline = Clock::now() + m_period;
+        m_skippedTicks = 0;
+    }
+
+    // Get the deadline of the current tick
+    Clock::time_point GetDeadline() const { return m_nextDeadline; }
+
+    // Get the number of deadlines dropped because a tick ran over by more than a whole period
+    uint64_t GetSkippedTicks() const { return m_skippedTicks; }
+
+    // Block until the current deadline and advance to the next one.
+    // Returns false without sleeping if the deadline has already passed.
+    bool WaitForNextTick() {
+        Clock::time_point now = Clock::now();
+        bool onTime = now < m_nextDeadline;
+        if (onTime) {
+            SleepUntil(m_nextDeadline);
+            m_nextDeadline += m_period;
+        } else if (now - m_nextDeadline >= m_period) {
+            // More than one period behind: drop the missed deadlines rather than running a burst of catch-up ticks
+            m_skippedTicks += static_cast<uint64_t>((now - m_nextDeadline) / m_period);
+            m_nextDeadline = now + m_period;
+        } else {
+            m_nextDeadline += m_period;
+        }
+        return onTime;
+    }
+};
+
+} // namespace CHULUBME
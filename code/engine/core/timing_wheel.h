@@ -0,0 +1,306 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "ecs.h"
+#include "memory.h"
+
+namespace CHULUBME {
+
+/**
+ * @brief What a timer stands for, so one queue can serve every gameplay system
+ */
+enum class TimerKind : uint8_t {
+    Cooldown,       // data = ability slot
+    StatusEffect,   // data = StatusEffectType
+    CastComplete,   // data = ability slot
+    NftYield,       // data = caller-defined yield id
+    Custom
+};
+
+/**
+ * @brief Payload delivered when a timer expires
+ */
+struct TimerEvent {
+    TimerKind kind;
+    uint32_t data;
+    Entity entity;
+    uint64_t userData;
+
+    // Tick the timer expired on (filled in on expiry)
+    uint64_t tick;
+};
+
+/**
+ * @brief Hierarchical timing wheel keyed on simulation tick
+ *
+ * Four levels of 256 slots cover 2^32 ticks at single-tick resolution; a
+ * timer is filed in the lowest level whose span reaches its deadline and is
+ * moved down a level each time the wheel turns past its slot, so pending
+ * timers cost nothing per tick and scheduling and cancelling are O(1).
+ * Timers due further out than the top level are re-filed until they come
+ * into range. Timers that expire on the same tick fire in the order they
+ * were scheduled, which keeps the simulation deterministic.
+ *
+ * An expiring timer either runs its callback or, without one, appends its
+ * event to the expired queue, which stays readable until the next Advance.
+ * Callbacks may schedule and cancel timers, including ones due on the same
+ * tick, but must not call Advance. A wheel belongs to one world and is not thread-safe.
+ */
+class TimingWheel {
+public:
+    // Called when a timer expires (instead of queuing its event)
+    using Callback = void (*)(const TimerEvent& event, void* context);
+
+    static constexpr uint32_t LEVEL_BITS = 8;
+    static constexpr uint32_t SLOTS = 1u << LEVEL_BITS;
+    static constexpr uint32_t LEVELS = 4;
+
+private:
+    struct TimerNode {
+        TimerNode* prev;
+        TimerNode* next;
+        uint64_t deadline;
+        uint64_t sequence;
+        TimerEvent event;
+        Callback callback;
+        void* context;
+        // Bucket index (level * SLOTS + slot), or FIRING while its tick is being processed
+        uint32_t bucket;
+        // Own pool handle
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    static constexpr uint32_t FIRING = LEVELS * SLOTS;
+
+public:
+    // Reference to a scheduled timer; stale once it has fired or been cancelled
+    using Handle = ObjectPool<TimerNode>::Handle;
+
+private:
+    ObjectPool<TimerNode> m_nodes;
+    TimerNode* m_buckets[LEVELS * SLOTS];
+    uint32_t m_levelCounts[LEVELS];
+
+    // Last processed tick
+    uint64_t m_currentTick;
+    uint64_t m_nextSequence;
+
+    // Length of a tick in seconds, for callers that think in durations
+    float m_tickDuration;
+
+    std::vector<TimerEvent> m_expired;
+    std::vector<Handle> m_firing;
+
+    static uint32_t SlotOf(uint64_t tick, uint32_t level) {
+        return static_cast<uint32_t>(tick >> (level * LEVEL_BITS)) & (SLOTS - 1);
+    }
+
+    void Link(TimerNode* node) {
+        uint64_t delta = node->deadline - m_currentTick;
+        uint32_t level = 0;
+        while (level + 1 < LEVELS && delta >= (uint64_t{1} << ((level + 1) * LEVEL_BITS))) {
+            ++level;
+        }
+        node->bucket = level * SLOTS + SlotOf(node->deadline, level);
+        ++m_levelCounts[level];
+        TimerNode*& head = m_buckets[node->bucket];
+        node->prev = nullptr;
+        node->next = head;
+        if (head) {
+            head->prev = node;
+        }
+        head = node;
+    }
+
+    void Unlink(TimerNode* node) {
+        --m_levelCounts[node->bucket / SLOTS];
+        if (node->prev) {
+            node->prev->next = node->next;
+        } else {
+            m_buckets[node->bucket] = node->next;
+        }
+        if (node->next) {
+            node->next->prev = node->prev;
+        }
+    }
+
+    // Re-file every timer of a bucket relative to the current tick
+    void Cascade(uint32_t level) {
+        TimerNode* node = m_buckets[level * SLOTS + SlotOf(m_currentTick, level)];
+        m_buckets[level * SLOTS + SlotOf(m_currentTick, level)] = nullptr;
+        while (node) {
+            TimerNode* next = node->next;
+            --m_levelCounts[level];
+            Link(node);
+            node = next;
+        }
+    }
+
+    // Process one tick: move due timers down the levels, then fire the level-0 slot
+    void Tick() {
+        ++m_currentTick;
+        uint32_t level = 1;
+        while (level < LEVELS && (m_currentTick & ((uint64_t{1} << (level * LEVEL_BITS)) - 1)) == 0) {
+            ++level;
+        }
+        while (--level > 0) {
+            Cascade(level);
+        }
+
+        TimerNode*& head = m_buckets[SlotOf(m_currentTick, 0)];
+        if (!head) {
+            return;
+        }
+        m_firing.clear();
+        for (TimerNode* node = head; node; node = node->next) {
+            --m_levelCounts[0];
+            node->bucket = FIRING;
+            m_firing.push_back(Handle(node->index, node->generation));
+        }
+        head = nullptr;
+        std::sort(m_firing.begin(), m_firing.end(), [this](Handle a, Handle b) {
+            return m_nodes.Get(a)->sequence < m_nodes.Get(b)->sequence;
+        });
+
+        for (size_t i = 0; i < m_firing.size(); ++i) {
+            TimerNode* node = m_nodes.Get(m_firing[i]);
+            if (!node) {
+                continue; // Cancelled by an earlier callback this tick
+            }
+            TimerEvent event = node->event;
+            event.tick = m_currentTick;
+            Callback callback = node->callback;
+            void* context = node->context;
+            m_nodes.Destroy(m_firing[i]);
+            if (callback) {
+                callback(event, context);
+            } else {
+                m_expired.push_back(event);
+            }
+        }
+    }
+
+public:
+    // Create a wheel whose last processed tick is currentTick
+    explicit TimingWheel(uint64_t currentTick = 0)
+        : m_nodes(256), m_currentTick(currentTick), m_nextSequence(0), m_tickDuration(1.0f / 30.0f) {
+        std::fill(m_buckets, m_buckets + LEVELS * SLOTS, nullptr);
+        std::fill(m_levelCounts, m_levelCounts + LEVELS, 0u);
+    }
+
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+
+    // Schedule a timer to expire delayTicks after the current tick (at least one tick ahead)
+    Handle Schedule(uint64_t delayTicks, const TimerEvent& event, Callback callback = nullptr, void* context = nullptr) {
+        return ScheduleAt(m_currentTick + (delayTicks > 0 ? delayTicks : 1), event, callback, context);
+    }
+
+    // Schedule a timer to expire on an absolute tick (past ticks expire on the next one)
+    Handle ScheduleAt(uint64_t tick, const TimerEvent& event, Callback callback = nullptr, void* context = nullptr) {
+        Handle handle = m_nodes.Create();
+        TimerNode* node = m_nodes.Get(handle);
+        if (!node) {
+            return Handle();
+        }
+        node->deadline = tick > m_currentTick ? tick : m_currentTick + 1;
+        node->sequence = m_nextSequence++;
+        node->event = event;
+        node->callback = callback;
+        node->context = context;
+        node->index = handle.index;
+        node->generation = handle.generation;
+        Link(node);
+        return handle;
+    }
+
+    // Cancel a pending timer; returns false if it already fired or was cancelled
+    bool Cancel(Handle handle) {
+        TimerNode* node = m_nodes.Get(handle);
+        if (!node) {
+            return false;
+        }
+        if (node->bucket != FIRING) {
+            Unlink(node);
+        }
+        m_nodes.Destroy(handle);
+        return true;
+    }
+
+    // Check if a timer is still pending
+    bool IsPending(Handle handle) const { return m_nodes.IsAlive(handle); }
+
+    // Get the ticks until a pending timer expires (0 if it is not pending)
+    uint64_t GetRemainingTicks(Handle handle) const {
+        const TimerNode* node = m_nodes.Get(handle);
+        return node ? node->deadline - m_currentTick : 0;
+    }
+
+    // Process every tick up to and including tick, firing due timers in deadline then scheduling order.
+    // Clears the expired queue first.
+    void Advance(uint64_t tick) {
+        m_expired.clear();
+        while (m_currentTick < tick) {
+            // With the lowest levels empty nothing fires or cascades before the next turn of the
+            // first occupied level, so jump to the tick before it
+            uint32_t emptyLevels = 0;
+            while (emptyLevels < LEVELS && m_levelCounts[emptyLevels] == 0) {
+                ++emptyLevels;
+            }
+            if (emptyLevels == LEVELS) {
+                m_currentTick = tick;
+                break;
+            }
+            if (emptyLevels > 0) {
+                uint64_t lastQuietTick = m_currentTick | ((uint64_t{1} << (emptyLevels * LEVEL_BITS)) - 1);
+                m_currentTick = lastQuietTick < tick ? lastQuietTick : tick;
+                if (m_currentTick == tick) {
+                    break;
+                }
+            }
+            Tick();
+        }
+    }
+
+    // Get the events of timers without a callback that expired in the last Advance
+    const std::vector<TimerEvent>& GetExpired() const { return m_expired; }
+
+    // Drop every timer and restart at currentTick
+    void Clear(uint64_t currentTick = 0) {
+        m_nodes.Clear();
+        std::fill(m_buckets, m_buckets + LEVELS * SLOTS, nullptr);
+        std::fill(m_levelCounts, m_levelCounts + LEVELS, 0u);
+        m_expired.clear();
+        m_currentTick = currentTick;
+        m_nextSequence = 0;
+    }
+
+    // Get the last processed tick
+    uint64_t GetCurrentTick() const { return m_currentTick; }
+
+    // Set the length of a tick in seconds (the owning world's fixed time step)
+    void SetTickDuration(float seconds) { m_tickDuration = seconds; }
+
+    // Get the length of a tick in seconds
+    float GetTickDuration() const { return m_tickDuration; }
+
+    // Convert a duration in seconds to whole ticks, rounding up so timers never expire early
+    uint64_t SecondsToTicks(float seconds) const {
+        if (seconds <= 0.0f) {
+            return 0;
+        }
+        uint64_t ticks = static_cast<uint64_t>(seconds / m_tickDuration);
+        return static_cast<float>(ticks) * m_tickDuration < seconds ? ticks + 1 : ticks;
+    }
+
+    // Convert whole ticks to seconds
+    float TicksToSeconds(uint64_t ticks) const { return static_cast<float>(ticks) * m_tickDuration; }
+
+    // Get the number of pending timers
+    size_t GetPendingCount() const { return m_nodes.GetCount(); }
+};
+
+} // namespace CHULUBME
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include "ecs.h"
+#include "job_system.h"
+#include "memory.h"
+#include "scheduler.h"
+#include "timing_wheel.h"
+
+namespace CHULUBME {
+
+/**
+ * @brief One isolated simulation (typically one match)
+ *
+ * A world owns its entity manager, systems, allocators and simulation
+ * timing; nothing in it is reachable from another world. Worlds share only
+ * the job system they are given and whatever read-only data (hero and
+ * ability templates) their systems are handed, so one process can host many
+ * matches side by side. Different worlds may be stepped concurrently from
+ * different jobs; a single world must only be stepped from one thread at a
+ * time.
+ *
+ * Step runs the simulation on a fixed-timestep accumulator. At most
+ * m_maxSubsteps ticks run per frame and the frame time fed in is clamped,
+ * so a hitch drops simulation time instead of making the next frame longer
+ * still (the spiral of death). What is left in the accumulator after the
+ * ticks is exposed as an interpolation alpha for rendering.
+ *
+ * Archetype chunks and anything allocated through GetArena or
+ * GetArenaResource come from a match-scoped arena. Teardown drops every
+ * entity without per-entity bookkeeping and releases the arena in one call,
+ * leaving the world ready for the next match.
+ *
+ * Deadlines live in the world's timing wheel (GetTimers, also reachable
+ * through EntityManager::GetTimers), keyed on the simulation tick: heroes
+ * schedule their ability cooldowns and status-effect expiries on it, and
+ * cast completion and similar deadlines belong there too. It is advanced
+ * at the start of every FixedUpdate, so systems see the events that
+ * expired on the tick they are running.
+ */
+class World {
+private:
+    // Name used in logs and statistics
+    std::string m_name;
+
+    // Shared job system (not owned)
+    JobSystem* m_jobSystem;
+
+    // Match-scoped arena backing chunk storage and other world-lifetime data
+    ArenaAllocator m_arena;
+    AllocatorResource m_arenaResource;
+
+    // Per-world allocators
+    std::unique_ptr<MemoryManager> m_memoryManager;
+
+    // Entities, components and systems of this world
+    std::unique_ptr<EntityManager> m_entityManager;
+
+    // Dispatches this world's systems onto the shared job system
+    std::unique_ptr<SystemScheduler> m_scheduler;
+
+    // Simulation timing
+    float m_deltaTime;
+    float m_fixedTimeStep;
+    float m_timeAccumulator;
+    uint64_t m_tick;
+
+    // Catch-up policy
+    uint32_t m_maxSubsteps;
+    float m_maxFrameTime;
+
+    // Fraction of a tick left in the accumulator after the last Step, in [0, 1)
+    float m_interpolationAlpha;
+
+    // Simulation ticks dropped by the catch-up policy
+    uint64_t m_droppedTicks;
+
+    // Tick-keyed timers of this world
+    TimingWheel m_timers;
+
+public:
+    // Create a world that schedules its systems on the given job system (null runs them serially)
+    explicit World(JobSystem* jobSystem, std::string name = std::string(), size_t arenaSize = 4 * 1024 * 1024)
+        : m_name(std::move(name)), m_jobSystem(jobSystem),
+          m_arena(arenaSize), m_arenaResource(m_arena),
+          m_memoryManager(new MemoryManager()),
+          m_entityManager(new EntityManager(&m_arena)),
+          m_scheduler(new SystemScheduler(m_entityManager.get(), jobSystem)),
+          m_deltaTime(0.0f), m_fixedTimeStep(1.0f / 30.0f), m_timeAccumulator(0.0f), m_tick(0),
+          m_maxSubsteps(5), m_maxFrameTime(0.25f), m_interpolationAlpha(0.0f), m_droppedTicks(0) {
+        m_memoryManager->Initialize();
+        m_timers.SetTickDuration(m_fixedTimeStep);
+        m_entityManager->SetTimers(&m_timers);
+    }
+
+    // Systems are destroyed before the allocators they may have drawn from
+    ~World() {
+        m_entityManager->Teardown();
+        m_scheduler.reset();
+        m_entityManager.reset();
+        m_memoryManager->Shutdown();
+    }
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    // Register a system with this world's entity manager
+    template<typename T, typename... Args>
+    T* RegisterSystem(Args&&... args) {
+        return m_entityManager->RegisterSystem<T>(std::forward<Args>(args)...);
+    }
+
+    // Get a registered system
+    template<typename T>
+    T* GetSystem() { return m_entityManager->GetSystem<T>(); }
+
+    // Run every system's Update, then flush command buffers
+    void Update(float deltaTime) {
+        m_deltaTime = deltaTime;
+        m_scheduler->Run(SystemScheduler::Phase::Update, deltaTime);
+        m_entityManager->FlushCommandBuffers();
+    }
+
+    // Run one simulation tick: fire the timers due on it, run every system's FixedUpdate, then flush
+    // command buffers
+    void FixedUpdate() {
+        m_timers.Advance(m_tick);
+        m_scheduler->Run(SystemScheduler::Phase::FixedUpdate, m_fixedTimeStep);
+        m_entityManager->FlushCommandBuffers();
+        ++m_tick;
+    }
+
+    // Advance by a frame's elapsed time: Update once, then the accumulated fixed ticks (at most
+    // m_maxSubsteps); returns the number of ticks run
+    uint32_t Step(float deltaTime) {
+        Update(deltaTime);
+
+        m_timeAccumulator += deltaTime < m_maxFrameTime ? deltaTime : m_maxFrameTime;
+        uint32_t substeps = 0;
+        while (m_timeAccumulator >= m_fixedTimeStep && substeps < m_maxSubsteps) {
+            FixedUpdate();
+            m_timeAccumulator -= m_fixedTimeStep;
+            ++substeps;
+        }
+
+        // Still behind after the budget: drop whole ticks, keep the fraction for interpolation
+        if (m_timeAccumulator >= m_fixedTimeStep) {
+            uint64_t behind = static_cast<uint64_t>(m_timeAccumulator / m_fixedTimeStep);
+            m_droppedTicks += behind;
+            m_timeAccumulator -= static_cast<float>(behind) * m_fixedTimeStep;
+        }
+        m_interpolationAlpha = m_timeAccumulator / m_fixedTimeStep;
+        if (m_interpolationAlpha >= 1.0f) {
+            m_interpolationAlpha = 0.0f;
+            m_timeAccumulator = 0.0f;
+        }
+        return substeps;
+    }
+
+    // Run systems' Render
+    void Render() { m_entityManager->Render(); }
+
+    // End the match: drop every entity (EntityManager::Teardown, which also calls each system's
+    // OnTeardown), release the arena in one call and reset timing. Systems stay registered. Nothing allocated from the arena may be used afterwards.
+    void Teardown() {
+        m_entityManager->Teardown();
+        m_entityManager->ReleaseChunkMemory();
+        m_arena.Release();
+        m_timers.Clear();
+        m_timeAccumulator = 0.0f;
+        m_interpolationAlpha = 0.0f;
+        m_tick = 0;
+        m_droppedTicks = 0;
+    }
+
+    // Get the world's name
+    const std::string& GetName() const { return m_name; }
+
+    // Get the entity manager
+    EntityManager* GetEntityManager() const { return m_entityManager.get(); }
+
+    // Get the system scheduler
+    SystemScheduler* GetScheduler() const { return m_scheduler.get(); }
+
+    // Get the world's allocators
+    MemoryManager* GetMemoryManager() const { return m_memoryManager.get(); }
+
+    // Get the match-scoped arena (thread-safe; released by Teardown)
+    ArenaAllocator& GetArena() { return m_arena; }
+
+    // Get the arena as a memory_resource for containers that live as long as the match
+    std::pmr::memory_resource* GetArenaResource() { return &m_arenaResource; }
+
+    // Get the shared job system
+    JobSystem* GetJobSystem() const { return m_jobSystem; }
+
+    // Get the delta time of the last Update
+    float GetDeltaTime() const { return m_deltaTime; }
+
+    // Set the simulation time step
+    void SetFixedTimeStep(float timeStep) {
+        m_fixedTimeStep = timeStep;
+        m_timers.SetTickDuration(timeStep);
+    }
+
+    // Get the simulation time step
+    float GetFixedTimeStep() const { return m_fixedTimeStep; }
+
+    // Get the number of simulation ticks run so far
+    uint64_t GetTick() const { return m_tick; }
+
+    // Get the timing wheel (world-thread only; schedule from systems' serial phases or command playback)
+    TimingWheel& GetTimers() { return m_timers; }
+
+    // Convert a duration in seconds to whole simulation ticks, rounding up so timers never expire early
+    uint64_t SecondsToTicks(float seconds) const { return m_timers.SecondsToTicks(seconds); }
+
+    // Set the most fixed ticks one Step may run
+    void SetMaxSubsteps(uint32_t maxSubsteps) { m_maxSubsteps = maxSubsteps > 0 ? maxSubsteps : 1; }
+
+    // Get the most fixed ticks one Step may run
+    uint32_t GetMaxSubsteps() const { return m_maxSubsteps; }
+
+    // Set the longest frame time Step accumulates; longer frames are clamped to it
+    void SetMaxFrameTime(float maxFrameTime) { m_maxFrameTime = maxFrameTime; }
+
+    // Get the longest frame time Step accumulates
+    float GetMaxFrameTime() const { return m_maxFrameTime; }
+
+    // Get how far rendering is between the previous and the current tick, in [0, 1)
+    float GetInterpolationAlpha() const { return m_interpolationAlpha; }
+
+    // Get the number of ticks dropped because Step fell too far behind
+    uint64_t GetDroppedTicks() const { return m_droppedTicks; }
+};
+
+} // namespace CHULUBME
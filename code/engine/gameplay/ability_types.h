@@ -3,7 +3,10 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <mutex>
 #include <unordered_map>
 #include "../core/ecs.h"
 
@@ -36,12 +39,81 @@ enum class AbilityEffectType {
     MOVEMENT        // Movement effect
 };
 
+// Dense process-wide id of an ability name
+using AbilityId = uint32_t;
+
+// Id of an ability name that was never interned
+constexpr AbilityId INVALID_ABILITY_ID = 0xFFFFFFFFu;
+
+/**
+ * @brief Interns ability names to dense ids shared by every world
+ *
+ * Names are interned once, when ability templates are loaded or built, so
+ * gameplay code compares integers instead of hashing strings. Ids are
+ * assigned in order of first use and never reused. Interning takes a lock
+ * and belongs to load time and tooling, not to per-tick code.
+ */
+class AbilityRegistry {
+private:
+    struct State {
+        std::mutex mutex;
+        std::unordered_map<std::string, AbilityId> ids;
+        // Deque so names keep their address as more are interned
+        std::deque<std::string> names;
+    };
+
+    static State& GetState() {
+        static State s_state;
+        return s_state;
+    }
+
+public:
+    // Get the id of a name, assigning the next id if it is new
+    static AbilityId Intern(const std::string& name) {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        auto it = state.ids.find(name);
+        if (it != state.ids.end()) {
+            return it->second;
+        }
+        AbilityId id = static_cast<AbilityId>(state.names.size());
+        state.names.push_back(name);
+        state.ids.emplace(name, id);
+        return id;
+    }
+
+    // Get the id of a name, or INVALID_ABILITY_ID if it was never interned
+    static AbilityId Find(const std::string& name) {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        auto it = state.ids.find(name);
+        return it != state.ids.end() ? it->second : INVALID_ABILITY_ID;
+    }
+
+    // Get the name of an id (empty for unknown ids)
+    static const std::string& GetName(AbilityId id) {
+        static const std::string s_empty;
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return id < state.names.size() ? state.names[id] : s_empty;
+    }
+
+    // Get the number of interned names
+    static size_t GetCount() {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.names.size();
+    }
+};
+
 /**
  * @brief Ability data
  */
 struct AbilityData {
     // Basic info
     std::string name;
+    // Interned name (assigned by AbilityComponent::SetData)
+    AbilityId id = INVALID_ABILITY_ID;
     std::string description;
     std::string icon;
     
@@ -96,12 +168,20 @@ public:
     // Finalize the component
     void Finalize() override;
     
-    // Set ability data
-    void SetData(const AbilityData& data) { m_data = data; }
+    // Set ability data, interning its name if it has no id yet (templates are built this way at load time)
+    void SetData(const AbilityData& data) {
+        m_data = data;
+        if (m_data.id == INVALID_ABILITY_ID && !m_data.name.empty()) {
+            m_data.id = AbilityRegistry::Intern(m_data.name);
+        }
+    }
     
     // Get ability data
     const AbilityData& GetData() const { return m_data; }
     
+    // Get the interned ability id
+    AbilityId GetId() const { return m_data.id; }
+    
     // Set owner entity
     void SetOwner(Entity owner) { m_owner = owner; }
     
@@ -263,9 +343,16 @@ public:
  * @brief Ability system for managing abilities
  */
 class AbilitySystem : public System {
+public:
+    // Template name -> ability template
+    using AbilityTemplateMap = std::unordered_map<std::string, std::shared_ptr<AbilityComponent>>;
+
 private:
-    // Ability templates
-    std::unordered_map<std::string, std::shared_ptr<AbilityComponent>> m_abilityTemplates;
+    // Ability templates registered with this world
+    AbilityTemplateMap m_abilityTemplates;
+    
+    // Read-only templates shared by every world in the process (may be null)
+    std::shared_ptr<const AbilityTemplateMap> m_sharedTemplates;
     
     // Active abilities
     std::vector<Entity> m_activeAbilities;
@@ -283,18 +370,33 @@ public:
     // Called when an entity is added to this system
     void OnEntityAdded(Entity entity) override;
     
-    // Called when an entity is removed from this system
+    // Called when an entity is removed from this system (cleanup of owned entities goes through the command buffer)
     void OnEntityRemoved(Entity entity) override;
     
-    // Register an ability template
+    // Register an ability template (its name is interned through SetData, so heroes key cooldowns by id)
     void RegisterAbilityTemplate(const std::string& name, std::shared_ptr<AbilityComponent> abilityTemplate);
     
-    // Get an ability template
+    // Get an ability template (this world's templates first, then the shared set)
     std::shared_ptr<AbilityComponent> GetAbilityTemplate(const std::string& name) const;
     
+    // Get the templates registered with this world
+    const AbilityTemplateMap& GetAbilityTemplates() const { return m_abilityTemplates; }
+    
+    // Use a read-only template set shared between worlds
+    void SetSharedTemplates(std::shared_ptr<const AbilityTemplateMap> templates) { m_sharedTemplates = std::move(templates); }
+    
+    // Get the shared template set
+    const std::shared_ptr<const AbilityTemplateMap>& GetSharedTemplates() const { return m_sharedTemplates; }
+    
+    // Load ability templates once for sharing between worlds
+    static std::shared_ptr<const AbilityTemplateMap> LoadSharedTemplatesFromFile(const std::string& filename);
+    
     // Create an ability from a template
     Entity CreateAbility(const std::string& templateName, Entity owner);
     
+    // Record the creation of an ability from a template; returns a provisional handle valid until the next flush
+    Entity CreateAbility(const std::string& templateName, Entity owner, EntityCommandBuffer& commands);
+    
     // Create a custom ability
     Entity CreateCustomAbility(const AbilityData& data, Entity owner);
     
@@ -0,0 +1,426 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "../core/cpu_features.h"
+#include "../core/ecs.h"
+#include "../core/float_determinism.h"
+#include "../core/thread_slot.h"
+#include "hero_system.h"
+#include "status_effects.h"
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace CHULUBME {
+
+/**
+ * @brief Kind of a combat event, which decides the resist that mitigates it
+ */
+enum class CombatEventType : uint8_t {
+    Physical,   // Mitigated by armor
+    Magical,    // Mitigated by magic resist
+    True,       // Not mitigated
+    Heal
+};
+
+// Combat event flags
+constexpr uint8_t COMBAT_CAN_CRIT = 1u << 0;    // Rolls against the source's crit chance
+constexpr uint8_t COMBAT_LIFESTEAL = 1u << 1;   // Heals the source by its life steal share of the damage
+
+/**
+ * @brief Damage or healing an ability wants dealt, resolved later by CombatResolveSystem
+ */
+struct CombatEvent {
+    Entity source;
+    Entity target;
+    // Raw amount before mitigation and crits (always positive)
+    float amount;
+    CombatEventType type;
+    uint8_t flags;
+};
+
+/**
+ * @brief Outcome of one resolved combat event
+ */
+struct CombatResult {
+    Entity source;
+    Entity target;
+    // Amount after mitigation and crits (0 if the target was invulnerable); damage may overkill
+    float amount;
+    CombatEventType type;
+    bool critical;
+    bool killed;
+};
+
+/**
+ * @brief Per-thread queues of pending combat events
+ *
+ * Each thread pushes into its own buffer (indexed by ThreadSlot, created on
+ * first use like EntityManager's command buffers), so abilities executing
+ * in parallel never contend. Drain collects every buffer while no thread is
+ * pushing.
+ */
+class CombatEventQueue {
+private:
+    std::unique_ptr<std::atomic<std::vector<CombatEvent>*>[]> m_buffers;
+
+    std::vector<CombatEvent>& GetBuffer() {
+        std::atomic<std::vector<CombatEvent>*>& entry = m_buffers[ThreadSlot::Current()];
+        std::vector<CombatEvent>* buffer = entry.load(std::memory_order_acquire);
+        if (!buffer) {
+            // Only the owning thread ever creates its slot's buffer
+            buffer = new std::vector<CombatEvent>();
+            entry.store(buffer, std::memory_order_release);
+        }
+        return *buffer;
+    }
+
+public:
+    CombatEventQueue() : m_buffers(new std::atomic<std::vector<CombatEvent>*>[ThreadSlot::MAX_SLOTS]) {
+        for (uint32_t i = 0; i < ThreadSlot::MAX_SLOTS; ++i) {
+            m_buffers[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~CombatEventQueue() {
+        for (uint32_t i = 0; i < ThreadSlot::MAX_SLOTS; ++i) {
+            delete m_buffers[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    CombatEventQueue(const CombatEventQueue&) = delete;
+    CombatEventQueue& operator=(const CombatEventQueue&) = delete;
+
+    // Queue an event from the calling thread (events without a positive amount are dropped)
+    void Push(const CombatEvent& event) {
+        if (event.amount > 0.0f) {
+            GetBuffer().push_back(event);
+        }
+    }
+
+    // Queue damage from the calling thread
+    void PushDamage(Entity source, Entity target, float amount, CombatEventType type, uint8_t flags = 0) {
+        Push(CombatEvent{source, target, amount, type, flags});
+    }
+
+    // Queue healing from the calling thread
+    void PushHeal(Entity source, Entity target, float amount) {
+        Push(CombatEvent{source, target, amount, CombatEventType::Heal, 0});
+    }
+
+    // Append every thread's events to out and empty the buffers. Must be called while no thread is pushing.
+    void Drain(std::vector<CombatEvent>& out) {
+        for (uint32_t slot = 0; slot < ThreadSlot::MAX_SLOTS; ++slot) {
+            if (std::vector<CombatEvent>* buffer = m_buffers[slot].load(std::memory_order_acquire)) {
+                out.insert(out.end(), buffer->begin(), buffer->end());
+                buffer->clear();
+            }
+        }
+    }
+
+    // Drop every pending event
+    void Clear() {
+        for (uint32_t slot = 0; slot < ThreadSlot::MAX_SLOTS; ++slot) {
+            if (std::vector<CombatEvent>* buffer = m_buffers[slot].load(std::memory_order_acquire)) {
+                buffer->clear();
+            }
+        }
+    }
+};
+
+CHULUBME_FP_CONTRACT_OFF_BEGIN
+
+// Damage multiplier of a resist: 100 / (100 + resist), or 2 - 100 / (100 - resist) for negative resist
+inline float GetResistMultiplier(float resist) {
+    return resist >= 0.0f ? 100.0f / (100.0f + resist) : 2.0f - 100.0f / (100.0f - resist);
+}
+
+#if CHULUBME_HAS_AVX2_KERNELS
+// AVX2 part of MitigateCombatBatch: mitigates the events in whole groups of eight and returns how
+// many it did (only called when HasAvx2())
+CHULUBME_TARGET_AVX2 inline size_t MitigateCombatBatchAvx2(const float* amount, const float* resist, const float* scale,
+                                                          float* out, size_t count) {
+    size_t i = 0;
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 hundred = _mm256_set1_ps(100.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m256 r = _mm256_loadu_ps(resist + i);
+        __m256 positive = _mm256_div_ps(hundred, _mm256_add_ps(hundred, r));
+        __m256 negative = _mm256_sub_ps(two, _mm256_div_ps(hundred, _mm256_sub_ps(hundred, r)));
+        __m256 multiplier = _mm256_blendv_ps(negative, positive, _mm256_cmp_ps(r, zero, _CMP_GE_OQ));
+        __m256 value = _mm256_mul_ps(_mm256_loadu_ps(amount + i), multiplier);
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(value, _mm256_loadu_ps(scale + i)));
+    }
+    return i;
+}
+#endif
+
+// Compute out[i] = amount[i] * GetResistMultiplier(resist[i]) * scale[i] for count events, eight
+// (AVX2, picked at run time on x86, see cpu_features.h) or four (NEON) at a time. Division is
+// correctly rounded and, with contraction off (see float_determinism.h), nothing is fused into FMA,
+// so the vector paths and the scalar tail match the scalar expression bit for bit.
+inline void MitigateCombatBatch(const float* amount, const float* resist, const float* scale, float* out, size_t count) {
+    size_t i = 0;
+#if CHULUBME_HAS_AVX2_KERNELS
+    if (HasAvx2()) {
+        i = MitigateCombatBatchAvx2(amount, resist, scale, out, count);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    // Vector division is AArch64 only
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t two = vdupq_n_f32(2.0f);
+    const float32x4_t hundred = vdupq_n_f32(100.0f);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t r = vld1q_f32(resist + i);
+        float32x4_t positive = vdivq_f32(hundred, vaddq_f32(hundred, r));
+        float32x4_t negative = vsubq_f32(two, vdivq_f32(hundred, vsubq_f32(hundred, r)));
+        float32x4_t multiplier = vbslq_f32(vcgeq_f32(r, zero), positive, negative);
+        float32x4_t value = vmulq_f32(vld1q_f32(amount + i), multiplier);
+        vst1q_f32(out + i, vmulq_f32(value, vld1q_f32(scale + i)));
+    }
+#endif
+    for (; i < count; ++i) {
+        float value = amount[i] * GetResistMultiplier(resist[i]);
+        out[i] = value * scale[i];
+    }
+}
+
+/**
+ * @brief Resolves every queued combat event of a tick in one deterministic batch
+ *
+ * Abilities push damage and healing into the system's CombatEventQueue
+ * from any thread instead of calling HeroComponent::TakeDamage directly.
+ * On FixedUpdate the queued events are merged and sorted by target, then
+ * source, type, amount and flags; events that compare equal are
+ * interchangeable, so the outcome never depends on which thread pushed
+ * what. Resists (after ArmorReduction and MagicResistReduction) and crit
+ * rolls are gathered into arrays and mitigated by MitigateCombatBatch,
+ * then each target's events are applied in order: Invulnerable targets
+ * ignore damage, GrievousWounds reduces healing, and a target that drops
+ * to zero health dies and ignores the rest of its events. Life steal heals
+ * sources after every target has been processed.
+ *
+ * Crit rolls hash the seed, the resolve count, the source, the target and
+ * the event's ordinal among that pair's events, so replays with the same
+ * seed and inputs roll the same crits. critChance and lifeSteal are
+ * fractions and critDamage is the total multiplier of a crit. Like the
+ * batch kernel, the gather and apply passes are compiled without
+ * floating-point contraction, so resist reductions and life steal round
+ * the same on every machine.
+ *
+ * The system declares no component access, so the scheduler runs it on its
+ * own, after every system registered before it; register it after the
+ * systems that push events.
+ */
+class CombatResolveSystem : public System {
+private:
+    CombatEventQueue m_queue;
+
+    // Seed of crit rolls and number of resolves so far
+    uint64_t m_seed;
+    uint64_t m_resolveCount;
+
+    // Scratch arrays reused by every resolve
+    std::vector<CombatEvent> m_events;
+    std::vector<float> m_amounts;
+    std::vector<float> m_resists;
+    std::vector<float> m_scales;
+    std::vector<float> m_mitigated;
+    std::vector<uint8_t> m_critical;
+
+    // Life steal owed to sources, applied after every target
+    struct LifeSteal {
+        Entity source;
+        float amount;
+    };
+    std::vector<LifeSteal> m_lifeSteal;
+
+    // Outcomes of the last resolve
+    std::vector<CombatResult> m_results;
+
+    static uint64_t EntityKey(Entity entity) { return (static_cast<uint64_t>(entity.index) << 32) | entity.generation; }
+
+    static bool EventLess(const CombatEvent& a, const CombatEvent& b) {
+        if (EntityKey(a.target) != EntityKey(b.target)) {
+            return EntityKey(a.target) < EntityKey(b.target);
+        }
+        if (EntityKey(a.source) != EntityKey(b.source)) {
+            return EntityKey(a.source) < EntityKey(b.source);
+        }
+        if (a.type != b.type) {
+            return a.type < b.type;
+        }
+        if (a.amount != b.amount) {
+            return a.amount < b.amount;
+        }
+        return a.flags < b.flags;
+    }
+
+    // SplitMix64 finalizer
+    static uint64_t Mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    // Uniform roll in [0, 1) for the ordinal-th event from source to target in this resolve
+    float RollCrit(Entity source, Entity target, uint32_t ordinal) const {
+        uint64_t hash = Mix(m_seed ^ Mix(m_resolveCount ^ Mix(EntityKey(source) ^ Mix(EntityKey(target) + ordinal))));
+        return static_cast<float>(hash >> 40) * (1.0f / 16777216.0f);
+    }
+
+    // Share of healing that gets through GrievousWounds
+    static float GetHealScale(const HeroComponent& hero) {
+        float scale = 1.0f - hero.m_statusEffects.GetMagnitude(StatusEffectType::GrievousWounds);
+        return scale > 0.0f ? scale : 0.0f;
+    }
+
+    static void ApplyHeal(HeroComponent& hero, float amount) {
+        float health = hero.m_currentHealth + amount;
+        hero.m_currentHealth = health < hero.m_currentStats.health ? health : hero.m_currentStats.health;
+    }
+
+    // Fill the resist and scale of every sorted event (reads heroes only, so their chunks are not marked changed)
+    void Gather() {
+        size_t count = m_events.size();
+        m_amounts.resize(count);
+        m_resists.resize(count);
+        m_scales.resize(count);
+        m_mitigated.resize(count);
+        m_critical.assign(count, 0);
+
+        const HeroComponent* target = nullptr;
+        uint32_t ordinal = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const CombatEvent& event = m_events[i];
+            bool newTarget = i == 0 || EntityKey(event.target) != EntityKey(m_events[i - 1].target);
+            if (newTarget) {
+                target = m_entityManager->GetComponent<const HeroComponent>(event.target);
+            }
+            ordinal = newTarget || EntityKey(event.source) != EntityKey(m_events[i - 1].source) ? 0 : ordinal + 1;
+
+            m_amounts[i] = event.amount;
+            m_resists[i] = 0.0f;
+            m_scales[i] = 1.0f;
+            if (!target) {
+                continue;
+            }
+
+            const StatusEffectSet& effects = target->m_statusEffects;
+            switch (event.type) {
+                case CombatEventType::Physical:
+                    m_resists[i] = target->m_currentStats.armor - effects.GetMagnitude(StatusEffectType::ArmorReduction);
+                    break;
+                case CombatEventType::Magical:
+                    m_resists[i] = target->m_currentStats.magicResist - effects.GetMagnitude(StatusEffectType::MagicResistReduction);
+                    break;
+                case CombatEventType::True:
+                    break;
+                case CombatEventType::Heal:
+                    m_scales[i] = GetHealScale(*target);
+                    break;
+            }
+
+            if ((event.flags & COMBAT_CAN_CRIT) && event.type != CombatEventType::Heal) {
+                const HeroComponent* source = m_entityManager->GetComponent<const HeroComponent>(event.source);
+                if (source && RollCrit(event.source, event.target, ordinal) < source->m_currentStats.critChance) {
+                    m_scales[i] = source->m_currentStats.critDamage;
+                    m_critical[i] = 1;
+                }
+            }
+        }
+    }
+
+    // Apply the mitigated events target by target
+    void Apply() {
+        size_t count = m_events.size();
+        for (size_t begin = 0; begin < count;) {
+            size_t end = begin + 1;
+            while (end < count && EntityKey(m_events[end].target) == EntityKey(m_events[begin].target)) {
+                ++end;
+            }
+
+            HeroComponent* target = m_entityManager->GetComponent<HeroComponent>(m_events[begin].target);
+            bool invulnerable = target && target->m_statusEffects.Has(StatusEffectType::Invulnerable);
+            for (size_t i = begin; target && target->m_alive && i < end; ++i) {
+                const CombatEvent& event = m_events[i];
+                CombatResult result{event.source, event.target, m_mitigated[i], event.type, m_critical[i] != 0, false};
+                if (event.type == CombatEventType::Heal) {
+                    ApplyHeal(*target, result.amount);
+                } else if (invulnerable) {
+                    result.amount = 0.0f;
+                    result.critical = false;
+                } else {
+                    target->m_currentHealth -= result.amount;
+                    if (event.flags & COMBAT_LIFESTEAL) {
+                        m_lifeSteal.push_back(LifeSteal{event.source, result.amount});
+                    }
+                    if (target->m_currentHealth <= 0.0f) {
+                        target->m_currentHealth = 0.0f;
+                        target->m_alive = false;
+                        result.killed = true;
+                    }
+                }
+                m_results.push_back(result);
+            }
+            begin = end;
+        }
+
+        for (const LifeSteal& lifeSteal : m_lifeSteal) {
+            HeroComponent* source = m_entityManager->GetComponent<HeroComponent>(lifeSteal.source);
+            if (source && source->m_alive) {
+                float amount = lifeSteal.amount * source->m_currentStats.lifeSteal;
+                ApplyHeal(*source, amount * GetHealScale(*source));
+            }
+        }
+    }
+
+public:
+    explicit CombatResolveSystem(EntityManager* manager, uint64_t seed = 0)
+        : System(manager), m_seed(seed), m_resolveCount(0) {}
+
+    // Resolve the events queued since the last tick
+    void FixedUpdate(float /*fixedTimeStep*/) override { Resolve(); }
+
+    // Resolve every queued event now. Must be called while no thread is pushing.
+    void Resolve() {
+        m_events.clear();
+        m_results.clear();
+        m_lifeSteal.clear();
+        m_queue.Drain(m_events);
+        if (!m_events.empty()) {
+            std::sort(m_events.begin(), m_events.end(), EventLess);
+            Gather();
+            MitigateCombatBatch(m_amounts.data(), m_resists.data(), m_scales.data(), m_mitigated.data(), m_events.size());
+            Apply();
+        }
+        ++m_resolveCount;
+    }
+
+    // Get the queue abilities push events into (thread-safe)
+    CombatEventQueue& GetQueue() { return m_queue; }
+
+    // Set the crit roll seed (e.g. the match seed) and restart the resolve count
+    void SetSeed(uint64_t seed) {
+        m_seed = seed;
+        m_resolveCount = 0;
+    }
+
+    // Get the crit roll seed
+    uint64_t GetSeed() const { return m_seed; }
+
+    // Get the outcomes of the last resolve in resolve order (events on dead or non-hero targets have none)
+    const std::vector<CombatResult>& GetResults() const { return m_results; }
+};
+
+CHULUBME_FP_CONTRACT_OFF_END
+
+} // namespace CHULUBME
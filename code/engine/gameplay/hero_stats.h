@@ -0,0 +1,331 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../core/cpu_features.h"
+#include "../core/ecs.h"
+#include "../core/float_determinism.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace CHULUBME {
+
+/**
+ * @brief Stats for a hero
+ */
+struct HeroStats {
+    // Base stats
+    float health;
+    float mana;
+    float attackDamage;
+    float abilityPower;
+    float armor;
+    float magicResist;
+    float attackSpeed;
+    float movementSpeed;
+    float healthRegen;
+    float manaRegen;
+    float critChance;
+    float critDamage;
+    float lifeSteal;
+    float cooldownReduction;
+
+    // Per-level stat growth
+    float healthPerLevel;
+    float manaPerLevel;
+    float attackDamagePerLevel;
+    float abilityPowerPerLevel;
+    float armorPerLevel;
+    float magicResistPerLevel;
+    float attackSpeedPerLevel;
+
+    // Constructor with default values
+    HeroStats();
+};
+
+/**
+ * @brief A stat that current stats are computed for, in HeroStats declaration order
+ */
+enum class HeroStat : uint8_t {
+    Health,
+    Mana,
+    AttackDamage,
+    AbilityPower,
+    Armor,
+    MagicResist,
+    AttackSpeed,
+    MovementSpeed,
+    HealthRegen,
+    ManaRegen,
+    CritChance,
+    CritDamage,
+    LifeSteal,
+    CooldownReduction,
+    Count
+};
+
+// Number of computed stats
+constexpr size_t HERO_STAT_COUNT = static_cast<size_t>(HeroStat::Count);
+
+// Get the HeroStats field holding a stat's base value
+inline float HeroStats::* GetHeroStatField(HeroStat stat) {
+    static float HeroStats::* const s_fields[HERO_STAT_COUNT] = {
+        &HeroStats::health, &HeroStats::mana, &HeroStats::attackDamage, &HeroStats::abilityPower,
+        &HeroStats::armor, &HeroStats::magicResist, &HeroStats::attackSpeed, &HeroStats::movementSpeed,
+        &HeroStats::healthRegen, &HeroStats::manaRegen, &HeroStats::critChance, &HeroStats::critDamage,
+        &HeroStats::lifeSteal, &HeroStats::cooldownReduction};
+    return s_fields[static_cast<size_t>(stat)];
+}
+
+// Get the HeroStats field holding a stat's per-level growth, or null if the stat does not grow
+inline float HeroStats::* GetHeroStatGrowthField(HeroStat stat) {
+    static float HeroStats::* const s_fields[HERO_STAT_COUNT] = {
+        &HeroStats::healthPerLevel, &HeroStats::manaPerLevel, &HeroStats::attackDamagePerLevel,
+        &HeroStats::abilityPowerPerLevel, &HeroStats::armorPerLevel, &HeroStats::magicResistPerLevel,
+        &HeroStats::attackSpeedPerLevel, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
+    return s_fields[static_cast<size_t>(stat)];
+}
+
+/**
+ * @brief Flat and percentage bonuses applied on top of a hero's levelled stats
+ */
+struct HeroStatModifiers {
+    float flat[HERO_STAT_COUNT];
+    float percent[HERO_STAT_COUNT];
+
+    HeroStatModifiers() { Clear(); }
+
+    // Add a bonus (negative values remove one)
+    void Add(HeroStat stat, float flatBonus, float percentBonus) {
+        flat[static_cast<size_t>(stat)] += flatBonus;
+        percent[static_cast<size_t>(stat)] += percentBonus;
+    }
+
+    // Remove every bonus
+    void Clear() {
+        for (size_t i = 0; i < HERO_STAT_COUNT; ++i) {
+            flat[i] = 0.0f;
+            percent[i] = 0.0f;
+        }
+    }
+};
+
+CHULUBME_FP_CONTRACT_OFF_BEGIN
+
+// Compute current stats: (base + perLevel * (level - 1) + flat) * (1 + percent). Growth fields are
+// copied from base. The batched HeroStatTable kernels evaluate the same expression in the same order,
+// and none of them is contracted into FMA (see float_determinism.h).
+inline void ComputeHeroStats(const HeroStats& base, int level, const HeroStatModifiers& modifiers, HeroStats& current) {
+    current = base;
+    float levelOffset = static_cast<float>(level - 1);
+    for (size_t i = 0; i < HERO_STAT_COUNT; ++i) {
+        HeroStat stat = static_cast<HeroStat>(i);
+        float HeroStats::* growthField = GetHeroStatGrowthField(stat);
+        float growth = growthField ? base.*growthField : 0.0f;
+        float value = base.*GetHeroStatField(stat) + growth * levelOffset;
+        current.*GetHeroStatField(stat) = (value + modifiers.flat[i]) * (1.0f + modifiers.percent[i]);
+    }
+}
+
+/**
+ * @brief Stat inputs and results of every hero in structure-of-arrays form
+ *
+ * Each hero owns a row; every stat input (base, per-level growth, flat and
+ * percentage modifiers) and every result is a column, so a recompute runs
+ * straight down the columns LANES heroes at a time with AVX2 (picked at run
+ * time on x86, see cpu_features.h) or NEON, and a scalar loop elsewhere.
+ * Only blocks of LANES rows that contain a dirty row are recomputed. Every
+ * path, and ComputeHeroStats, is compiled with floating-point contraction
+ * off, so multiplies and adds are never fused and each path rounds exactly
+ * like ComputeHeroStats, keeping the simulation deterministic across
+ * machines and build flags.
+ */
+class HeroStatTable {
+public:
+    // Rows per block; columns are padded to a multiple of this
+    static constexpr uint32_t LANES = 8;
+
+    // Row of a hero that is not in a table
+    static constexpr uint32_t INVALID_ROW = 0xFFFFFFFFu;
+
+private:
+    enum Column : size_t {
+        BaseColumn = 0,
+        GrowthColumn = BaseColumn + HERO_STAT_COUNT,
+        FlatColumn = GrowthColumn + HERO_STAT_COUNT,
+        PercentColumn = FlatColumn + HERO_STAT_COUNT,
+        CurrentColumn = PercentColumn + HERO_STAT_COUNT,
+        LevelOffsetColumn = CurrentColumn + HERO_STAT_COUNT,
+        COLUMN_COUNT
+    };
+
+    std::vector<float> m_columns[COLUMN_COUNT];
+
+    // Owner of each row (invalid for free rows)
+    std::vector<Entity> m_entities;
+    std::vector<uint32_t> m_freeRows;
+
+    // One bit per row of each block
+    std::vector<uint8_t> m_dirtyMasks;
+    uint32_t m_dirtyBlockCount;
+
+    static_assert(LANES == 8, "Dirty masks hold one byte per block");
+
+    float* ColumnAt(size_t column, uint32_t row) { return m_columns[column].data() + row; }
+
+    void MarkDirty(uint32_t row) {
+        uint8_t& mask = m_dirtyMasks[row / LANES];
+        m_dirtyBlockCount += mask == 0 ? 1 : 0;
+        mask = static_cast<uint8_t>(mask | (1u << (row % LANES)));
+    }
+
+#if CHULUBME_HAS_AVX2_KERNELS
+    // Recompute LANES consecutive rows with AVX2 (only called when HasAvx2())
+    CHULUBME_TARGET_AVX2 void RecomputeBlockAvx2(uint32_t firstRow) {
+        const float* levelOffset = ColumnAt(LevelOffsetColumn, firstRow);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 level = _mm256_loadu_ps(levelOffset);
+        for (size_t stat = 0; stat < HERO_STAT_COUNT; ++stat) {
+            __m256 value = _mm256_add_ps(_mm256_loadu_ps(ColumnAt(BaseColumn + stat, firstRow)),
+                                         _mm256_mul_ps(_mm256_loadu_ps(ColumnAt(GrowthColumn + stat, firstRow)), level));
+            value = _mm256_add_ps(value, _mm256_loadu_ps(ColumnAt(FlatColumn + stat, firstRow)));
+            value = _mm256_mul_ps(value, _mm256_add_ps(one, _mm256_loadu_ps(ColumnAt(PercentColumn + stat, firstRow))));
+            _mm256_storeu_ps(ColumnAt(CurrentColumn + stat, firstRow), value);
+        }
+    }
+#endif
+
+    // Recompute LANES consecutive rows
+    void RecomputeBlock(uint32_t firstRow) {
+#if CHULUBME_HAS_AVX2_KERNELS
+        if (HasAvx2()) {
+            RecomputeBlockAvx2(firstRow);
+            return;
+        }
+#endif
+        const float* levelOffset = ColumnAt(LevelOffsetColumn, firstRow);
+#if defined(__ARM_NEON)
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        for (uint32_t half = 0; half < LANES; half += 4) {
+            const float32x4_t level = vld1q_f32(levelOffset + half);
+            for (size_t stat = 0; stat < HERO_STAT_COUNT; ++stat) {
+                uint32_t row = firstRow + half;
+                float32x4_t value = vaddq_f32(vld1q_f32(ColumnAt(BaseColumn + stat, row)),
+                                              vmulq_f32(vld1q_f32(ColumnAt(GrowthColumn + stat, row)), level));
+                value = vaddq_f32(value, vld1q_f32(ColumnAt(FlatColumn + stat, row)));
+                value = vmulq_f32(value, vaddq_f32(one, vld1q_f32(ColumnAt(PercentColumn + stat, row))));
+                vst1q_f32(ColumnAt(CurrentColumn + stat, row), value);
+            }
+        }
+#else
+        for (size_t stat = 0; stat < HERO_STAT_COUNT; ++stat) {
+            const float* base = ColumnAt(BaseColumn + stat, firstRow);
+            const float* growth = ColumnAt(GrowthColumn + stat, firstRow);
+            const float* flat = ColumnAt(FlatColumn + stat, firstRow);
+            const float* percent = ColumnAt(PercentColumn + stat, firstRow);
+            float* current = ColumnAt(CurrentColumn + stat, firstRow);
+            for (uint32_t lane = 0; lane < LANES; ++lane) {
+                float value = base[lane] + growth[lane] * levelOffset[lane];
+                current[lane] = (value + flat[lane]) * (1.0f + percent[lane]);
+            }
+        }
+#endif
+    }
+
+public:
+    HeroStatTable() : m_dirtyBlockCount(0) {}
+
+    // Add a row for a hero; its inputs must be set before the next Recompute
+    uint32_t AddRow(Entity entity) {
+        uint32_t row;
+        if (!m_freeRows.empty()) {
+            row = m_freeRows.back();
+            m_freeRows.pop_back();
+        } else {
+            row = static_cast<uint32_t>(m_entities.size());
+            m_entities.push_back(Entity());
+            if (row % LANES == 0) {
+                for (std::vector<float>& column : m_columns) {
+                    column.resize(row + LANES, 0.0f);
+                }
+                m_dirtyMasks.push_back(0);
+            }
+        }
+        m_entities[row] = entity;
+        return row;
+    }
+
+    // Release a hero's row
+    void RemoveRow(uint32_t row) {
+        m_entities[row] = Entity();
+        m_freeRows.push_back(row);
+    }
+
+    // Drop every row, keeping the capacity for the next match
+    void Clear() {
+        for (std::vector<float>& column : m_columns) {
+            column.clear();
+        }
+        m_entities.clear();
+        m_freeRows.clear();
+        m_dirtyMasks.clear();
+        m_dirtyBlockCount = 0;
+    }
+
+    // Copy a hero's stat inputs into its row and mark it for recompute
+    void SetInputs(uint32_t row, const HeroStats& base, int level, const HeroStatModifiers& modifiers) {
+        for (size_t i = 0; i < HERO_STAT_COUNT; ++i) {
+            HeroStat stat = static_cast<HeroStat>(i);
+            float HeroStats::* growthField = GetHeroStatGrowthField(stat);
+            *ColumnAt(BaseColumn + i, row) = base.*GetHeroStatField(stat);
+            *ColumnAt(GrowthColumn + i, row) = growthField ? base.*growthField : 0.0f;
+            *ColumnAt(FlatColumn + i, row) = modifiers.flat[i];
+            *ColumnAt(PercentColumn + i, row) = modifiers.percent[i];
+        }
+        *ColumnAt(LevelOffsetColumn, row) = static_cast<float>(level - 1);
+        MarkDirty(row);
+    }
+
+    // Recompute every dirty row, then call onRecomputed(entity, row) for each live one in row order
+    template<typename Fn>
+    void Recompute(Fn&& onRecomputed) {
+        if (m_dirtyBlockCount == 0) {
+            return;
+        }
+        for (uint32_t block = 0; block < m_dirtyMasks.size(); ++block) {
+            if (m_dirtyMasks[block] != 0) {
+                RecomputeBlock(block * LANES);
+            }
+        }
+        for (uint32_t block = 0; block < m_dirtyMasks.size(); ++block) {
+            for (uint32_t lane = 0; m_dirtyMasks[block] >> lane; ++lane) {
+                uint32_t row = block * LANES + lane;
+                if ((m_dirtyMasks[block] >> lane & 1u) && m_entities[row].IsValid()) {
+                    onRecomputed(m_entities[row], row);
+                }
+            }
+            m_dirtyMasks[block] = 0;
+        }
+        m_dirtyBlockCount = 0;
+    }
+
+    // Write a row's computed stats into current (growth fields are left as they are)
+    void ReadCurrent(uint32_t row, HeroStats& current) const {
+        for (size_t i = 0; i < HERO_STAT_COUNT; ++i) {
+            current.*GetHeroStatField(static_cast<HeroStat>(i)) = m_columns[CurrentColumn + i][row];
+        }
+    }
+
+    // Get the number of rows, including free ones
+    uint32_t GetRowCount() const { return static_cast<uint32_t>(m_entities.size()); }
+
+    // Check if any row waits for a recompute
+    bool HasDirtyRows() const { return m_dirtyBlockCount != 0; }
+};
+
+CHULUBME_FP_CONTRACT_OFF_END
+
+} // namespace CHULUBME
@@ -5,50 +5,26 @@
 #include <memory>
 #include <unordered_map>
 #include "../core/ecs.h"
+#include "../core/timing_wheel.h"
 #include "ability_types.h"
+#include "hero_stats.h"
+#include "status_effects.h"
 
 namespace CHULUBME {
 
 // Forward declarations
 class AbilityComponent;
-
-/**
- * @brief Stats for a hero
- */
-struct HeroStats {
-    // Base stats
-    float health;
-    float mana;
-    float attackDamage;
-    float abilityPower;
-    float armor;
-    float magicResist;
-    float attackSpeed;
-    float movementSpeed;
-    float healthRegen;
-    float manaRegen;
-    float critChance;
-    float critDamage;
-    float lifeSteal;
-    float cooldownReduction;
-    
-    // Per-level stat growth
-    float healthPerLevel;
-    float manaPerLevel;
-    float attackDamagePerLevel;
-    float abilityPowerPerLevel;
-    float armorPerLevel;
-    float magicResistPerLevel;
-    float attackSpeedPerLevel;
-    
-    // Constructor with default values
-    HeroStats();
-};
+class CombatResolveSystem;
+class HeroSystem;
 
 /**
  * @brief Hero component for MOBA heroes
  */
 class HeroComponent : public Component {
+public:
+    // Most abilities (including summoner spells and item actives) a hero tracks cooldowns for
+    static constexpr size_t MAX_ABILITY_SLOTS = 8;
+
 private:
     // Hero data
     std::string m_name;
@@ -58,6 +34,11 @@ private:
     // Hero stats
     HeroStats m_baseStats;
     HeroStats m_currentStats;
+    HeroStatModifiers m_statModifiers;
+    
+    // Row in the owning HeroSystem's stat table (null while the hero is not in a world)
+    HeroStatTable* m_statTable = nullptr;
+    uint32_t m_statRow = HeroStatTable::INVALID_ROW;
     
     // Hero level
     int m_level;
@@ -71,9 +52,28 @@ private:
     float m_currentMana;
     bool m_alive;
     
-    // Cooldowns and effects
-    std::unordered_map<std::string, float> m_cooldowns;
-    std::vector<std::pair<std::string, float>> m_statusEffects;
+    // Remaining cooldown per ability slot while the hero is not in a world, and the ability bound to each slot
+    AbilityId m_cooldownAbilities[MAX_ABILITY_SLOTS] = {INVALID_ABILITY_ID, INVALID_ABILITY_ID, INVALID_ABILITY_ID, INVALID_ABILITY_ID,
+                                                       INVALID_ABILITY_ID, INVALID_ABILITY_ID, INVALID_ABILITY_ID, INVALID_ABILITY_ID};
+    float m_cooldowns[MAX_ABILITY_SLOTS] = {};
+    static_assert(MAX_ABILITY_SLOTS == 8, "Update the m_cooldownAbilities initializer");
+    
+    // Active status effects
+    StatusEffectSet m_statusEffects;
+    
+    // World timing wheel the hero's cooldowns and status-effect expiries run on, with the entity manager
+    // and entity its timer events resolve through (null while the hero is not in a world)
+    TimingWheel* m_timers = nullptr;
+    EntityManager* m_timerManager = nullptr;
+    Entity m_timerEntity;
+    
+    // Pending cooldown timer per slot (a slot is on cooldown while its timer is pending) and expiry
+    // timer per active status effect
+    TimingWheel::Handle m_cooldownTimers[MAX_ABILITY_SLOTS];
+    TimingWheel::Handle m_statusTimers[STATUS_EFFECT_COUNT];
+    
+    // Wheel tick the status effects' remaining times were last counted down to
+    uint64_t m_statusSyncTick = 0;
     
     // Skin/NFT data
     std::string m_skinId;
@@ -81,9 +81,90 @@ private:
     
     // Blockchain wallet entity
     Entity m_wallet;
+    
+    // Queue a stat recompute in the owning HeroSystem's batched pass, or recompute now if there is none
+    void OnStatInputsChanged() {
+        if (m_statTable) {
+            m_statTable->SetInputs(m_statRow, m_baseStats, m_level, m_statModifiers);
+        } else {
+            ComputeHeroStats(m_baseStats, m_level, m_statModifiers, m_currentStats);
+        }
+    }
+    
+    // Count the status effects' remaining times down to the wheel's current tick
+    void SyncStatusEffects() {
+        uint64_t now = m_timers->GetCurrentTick();
+        if (now != m_statusSyncTick) {
+            m_statusEffects.Elapse(m_timers->TicksToSeconds(now - m_statusSyncTick));
+            m_statusSyncTick = now;
+        }
+    }
+    
+    // Schedule the expiry of a status effect's current application, replacing any earlier timer
+    void ScheduleStatusExpiry(StatusEffectType effect) {
+        TimingWheel::Handle& timer = m_statusTimers[static_cast<size_t>(effect)];
+        m_timers->Cancel(timer);
+        timer = TimingWheel::Handle();
+        if (m_statusEffects.Has(effect)) {
+            TimerEvent event{TimerKind::StatusEffect, static_cast<uint32_t>(effect), m_timerEntity, 0, 0};
+            timer = m_timers->Schedule(m_timers->SecondsToTicks(m_statusEffects.GetRemaining(effect)), event,
+                                       &HeroComponent::OnStatusEffectTimer, m_timerManager);
+        }
+    }
+    
+    // Expiry timer callback: end the effect's current application, rescheduling if a fallback takes over
+    static void OnStatusEffectTimer(const TimerEvent& event, void* context) {
+        HeroComponent* hero = static_cast<EntityManager*>(context)->GetComponent<HeroComponent>(event.entity);
+        StatusEffectType effect = static_cast<StatusEffectType>(event.data);
+        if (!hero || !hero->m_timers || !hero->m_statusEffects.Has(effect)) {
+            return;
+        }
+        hero->m_statusTimers[event.data] = TimingWheel::Handle();
+        hero->SyncStatusEffects();
+        if (!hero->m_statusEffects.Expire(effect)) {
+            hero->ScheduleStatusExpiry(effect);
+        }
+    }
+    
+    // Move cooldowns and status-effect expiries onto a world's timing wheel
+    void BindTimers(TimingWheel* timers, EntityManager* manager, Entity entity) {
+        m_timers = timers;
+        m_timerManager = manager;
+        m_timerEntity = entity;
+        m_statusSyncTick = timers->GetCurrentTick();
+        for (size_t slot = 0; slot < MAX_ABILITY_SLOTS; ++slot) {
+            float remaining = m_cooldowns[slot];
+            m_cooldowns[slot] = 0.0f;
+            SetSlotCooldown(slot, remaining);
+        }
+        for (size_t i = 0; i < STATUS_EFFECT_COUNT; ++i) {
+            ScheduleStatusExpiry(static_cast<StatusEffectType>(i));
+        }
+    }
+    
+    // Take cooldowns and status effects off the wheel, back to counting down in Update
+    void UnbindTimers() {
+        SyncStatusEffects();
+        for (size_t slot = 0; slot < MAX_ABILITY_SLOTS; ++slot) {
+            m_cooldowns[slot] = GetSlotCooldown(slot);
+            m_timers->Cancel(m_cooldownTimers[slot]);
+            m_cooldownTimers[slot] = TimingWheel::Handle();
+        }
+        for (TimingWheel::Handle& timer : m_statusTimers) {
+            m_timers->Cancel(timer);
+            timer = TimingWheel::Handle();
+        }
+        m_timers = nullptr;
+        m_timerManager = nullptr;
+        m_timerEntity = Entity();
+    }
+    
+    friend class CombatResolveSystem;
+    friend class HeroSystem;
 
 public:
     HeroComponent();
+    
     ~HeroComponent() override;
     
     // Initialize the component
@@ -111,15 +192,33 @@ public:
     const std::string& GetRole() const { return m_role; }
     
     // Set base stats
-    void SetBaseStats(const HeroStats& stats) { m_baseStats = stats; }
+    void SetBaseStats(const HeroStats& stats) {
+        m_baseStats = stats;
+        OnStatInputsChanged();
+    }
     
     // Get base stats
     const HeroStats& GetBaseStats() const { return m_baseStats; }
     
-    // Get current stats
+    // Get current stats (heroes in a world are refreshed by HeroSystem::RecomputeStats, once per update)
     const HeroStats& GetCurrentStats() const { return m_currentStats; }
     
-    // Set level
+    // Add a flat and percentage bonus to a stat (negative values remove one)
+    void AddStatModifier(HeroStat stat, float flat, float percent = 0.0f) {
+        m_statModifiers.Add(stat, flat, percent);
+        OnStatInputsChanged();
+    }
+    
+    // Remove every stat bonus
+    void ClearStatModifiers() {
+        m_statModifiers.Clear();
+        OnStatInputsChanged();
+    }
+    
+    // Get the stat bonuses
+    const HeroStatModifiers& GetStatModifiers() const { return m_statModifiers; }
+    
+    // Set level (stats are recomputed through OnStatInputsChanged)
     void SetLevel(int level);
     
     // Get level
@@ -155,10 +254,10 @@ public:
     // Check if hero is alive
     bool IsAlive() const { return m_alive; }
     
-    // Take damage
+    // Take damage immediately (tooling; gameplay queues damage through CombatResolveSystem)
     float TakeDamage(float damage, bool isMagical = false);
     
-    // Heal
+    // Heal immediately (tooling; gameplay queues healing through CombatResolveSystem)
     float Heal(float amount);
     
     // Use mana
@@ -167,23 +266,161 @@ public:
     // Restore mana
     float RestoreMana(float amount);
     
-    // Set cooldown
-    void SetCooldown(const std::string& ability, float duration);
+    // Bind an ability to a cooldown slot (AddAbility binds slots in ability order); clears the slot's cooldown
+    void SetAbilitySlot(size_t slot, AbilityId ability) {
+        if (slot < MAX_ABILITY_SLOTS) {
+            m_cooldownAbilities[slot] = ability;
+            SetSlotCooldown(slot, 0.0f);
+        }
+    }
+    
+    // Get the ability bound to a slot
+    AbilityId GetAbilitySlot(size_t slot) const { return slot < MAX_ABILITY_SLOTS ? m_cooldownAbilities[slot] : INVALID_ABILITY_ID; }
+    
+    // Get the slot an ability is bound to, or MAX_ABILITY_SLOTS if it has none
+    size_t FindAbilitySlot(AbilityId ability) const {
+        for (size_t slot = 0; slot < MAX_ABILITY_SLOTS; ++slot) {
+            if (m_cooldownAbilities[slot] == ability) {
+                return slot;
+            }
+        }
+        return MAX_ABILITY_SLOTS;
+    }
+    
+    // Set the cooldown of a slot. In a world this schedules a Cooldown timer (data = slot, userData =
+    // ability) whose event is queued on the wheel when the slot comes off cooldown.
+    void SetSlotCooldown(size_t slot, float duration) {
+        if (slot >= MAX_ABILITY_SLOTS) {
+            return;
+        }
+        if (!m_timers) {
+            m_cooldowns[slot] = duration;
+            return;
+        }
+        m_timers->Cancel(m_cooldownTimers[slot]);
+        m_cooldownTimers[slot] = TimingWheel::Handle();
+        if (duration > 0.0f) {
+            TimerEvent event{TimerKind::Cooldown, static_cast<uint32_t>(slot), m_timerEntity, m_cooldownAbilities[slot], 0};
+            m_cooldownTimers[slot] = m_timers->Schedule(m_timers->SecondsToTicks(duration), event);
+        }
+    }
+    
+    // Get the remaining cooldown of a slot (whole ticks in a world)
+    float GetSlotCooldown(size_t slot) const {
+        if (slot >= MAX_ABILITY_SLOTS) {
+            return 0.0f;
+        }
+        return m_timers ? m_timers->TicksToSeconds(m_timers->GetRemainingTicks(m_cooldownTimers[slot])) : m_cooldowns[slot];
+    }
+    
+    // Check if the ability in a slot is on cooldown
+    bool IsSlotOnCooldown(size_t slot) const {
+        if (slot >= MAX_ABILITY_SLOTS) {
+            return false;
+        }
+        return m_timers ? m_timers->IsPending(m_cooldownTimers[slot]) : m_cooldowns[slot] > 0.0f;
+    }
+    
+    // Set cooldown, binding the ability to a free slot if it has none (ignored when every slot is taken)
+    void SetCooldown(AbilityId ability, float duration) {
+        size_t slot = FindAbilitySlot(ability);
+        if (slot == MAX_ABILITY_SLOTS && ability != INVALID_ABILITY_ID) {
+            slot = FindAbilitySlot(INVALID_ABILITY_ID);
+            if (slot < MAX_ABILITY_SLOTS) {
+                m_cooldownAbilities[slot] = ability;
+            }
+        }
+        SetSlotCooldown(slot, duration);
+    }
     
     // Get cooldown
-    float GetCooldown(const std::string& ability) const;
+    float GetCooldown(AbilityId ability) const { return GetSlotCooldown(FindAbilitySlot(ability)); }
     
     // Check if ability is on cooldown
-    bool IsOnCooldown(const std::string& ability) const;
-    
-    // Add status effect
-    void AddStatusEffect(const std::string& effect, float duration);
+    bool IsOnCooldown(AbilityId ability) const { return IsSlotOnCooldown(FindAbilitySlot(ability)); }
+    
+    // Set cooldown by ability name (tooling; interns the name)
+    void SetCooldown(const std::string& ability, float duration) { SetCooldown(AbilityRegistry::Intern(ability), duration); }
+    
+    // Get cooldown by ability name (tooling)
+    float GetCooldown(const std::string& ability) const { return GetCooldown(AbilityRegistry::Find(ability)); }
+    
+    // Check if ability is on cooldown by name (tooling)
+    bool IsOnCooldown(const std::string& ability) const { return IsOnCooldown(AbilityRegistry::Find(ability)); }
+    
+    // Clear every cooldown, keeping slot bindings
+    void ResetCooldowns() {
+        for (size_t slot = 0; slot < MAX_ABILITY_SLOTS; ++slot) {
+            SetSlotCooldown(slot, 0.0f);
+        }
+    }
+    
+    // Apply a status effect following its catalogue stacking rule (in a world, its expiry is scheduled
+    // on the timing wheel)
+    void AddStatusEffect(StatusEffectType effect, float duration, float magnitude = 0.0f, Entity source = Entity()) {
+        if (!m_timers) {
+            m_statusEffects.Apply(effect, duration, magnitude, source);
+            return;
+        }
+        SyncStatusEffects();
+        m_statusEffects.Apply(effect, duration, magnitude, source);
+        ScheduleStatusExpiry(effect);
+    }
     
     // Remove status effect
-    void RemoveStatusEffect(const std::string& effect);
+    void RemoveStatusEffect(StatusEffectType effect) {
+        m_statusEffects.Remove(effect);
+        if (m_timers) {
+            ScheduleStatusExpiry(effect);
+        }
+    }
+    
+    // Get the time left on a status effect's current application (0 if inactive)
+    float GetStatusEffectRemaining(StatusEffectType effect) const {
+        float remaining = m_statusEffects.GetRemaining(effect);
+        if (m_timers && remaining > 0.0f) {
+            remaining -= m_timers->TicksToSeconds(m_timers->GetCurrentTick() - m_statusSyncTick);
+        }
+        return remaining;
+    }
     
     // Check if has status effect
-    bool HasStatusEffect(const std::string& effect) const;
+    bool HasStatusEffect(StatusEffectType effect) const { return m_statusEffects.Has(effect); }
+    
+    // Check if any crowd control stops the hero from moving
+    bool CanMove() const { return !m_statusEffects.HasAny(STATUS_BLOCKS_MOVEMENT); }
+    
+    // Check if any crowd control stops the hero from casting
+    bool CanCast() const { return !m_statusEffects.HasAny(STATUS_BLOCKS_CASTING); }
+    
+    // Check if any crowd control stops the hero from basic attacking
+    bool CanAttack() const { return !m_statusEffects.HasAny(STATUS_BLOCKS_ATTACKS); }
+    
+    // Get the status effects (in a world, slot remaining times are as of the last change; use
+    // GetStatusEffectRemaining for the live value)
+    const StatusEffectSet& GetStatusEffects() const { return m_statusEffects; }
+    
+    // Add status effect by catalogue name (tooling; unknown names are ignored)
+    void AddStatusEffect(const std::string& effect, float duration) {
+        StatusEffectType type;
+        if (StatusEffectCatalogue::Find(effect, type)) {
+            AddStatusEffect(type, duration);
+        }
+    }
+    
+    // Remove status effect by catalogue name (tooling)
+    void RemoveStatusEffect(const std::string& effect) {
+        StatusEffectType type;
+        if (StatusEffectCatalogue::Find(effect, type)) {
+            RemoveStatusEffect(type);
+        }
+    }
+    
+    // Check if has status effect by catalogue name (tooling)
+    bool HasStatusEffect(const std::string& effect) const {
+        StatusEffectType type;
+        return StatusEffectCatalogue::Find(effect, type) && HasStatusEffect(type);
+    }
     
     // Set skin
     void SetSkin(const std::string& skinId, const std::string& skinName);
@@ -200,7 +437,8 @@ public:
     // Get wallet entity
     Entity GetWallet() const { return m_wallet; }
     
-    // Update the hero
+    // Update the hero. Outside a world it counts down the cooldown slots and status effects (Tick); in a
+    // world they expire on the timing wheel and nothing is counted down per frame.
     void Update(float deltaTime);
     
     // Reset the hero (full health/mana, clear cooldowns and effects)
@@ -211,12 +449,19 @@ public:
  * @brief Hero system for managing heroes
  */
 class HeroSystem : public System {
+public:
+    // Template name -> hero template
+    using HeroTemplateMap = std::unordered_map<std::string, HeroComponent>;
+
 private:
-    // Hero templates
-    std::unordered_map<std::string, HeroComponent> m_heroTemplates;
+    // Hero templates registered with this world
+    HeroTemplateMap m_heroTemplates;
+    
+    // Read-only templates shared by every world in the process (may be null)
+    std::shared_ptr<const HeroTemplateMap> m_sharedTemplates;
     
-    // Active heroes
-    std::vector<Entity> m_activeHeroes;
+    // Stat inputs and results of every hero in this world, recomputed in batches
+    HeroStatTable m_statTable;
     
     // Hero factory methods
     Entity CreateHeroFromTemplate(const std::string& templateName);
@@ -228,29 +473,101 @@ public:
     // Initialize the system
     void Initialize() override;
     
-    // Update the system
+    // Update the system (starts with RecomputeStats)
     void Update(float deltaTime) override;
     
-    // Called when an entity is added to this system
+    // Called when an entity is added to this system (AttachStats, then AttachTimers)
     void OnEntityAdded(Entity entity) override;
     
-    // Called when an entity is removed from this system
+    // Called when an entity is removed from this system (DetachTimers, then DetachStats; cleanup of owned
+    // entities goes through the command buffer)
     void OnEntityRemoved(Entity entity) override;
     
+    // Called when the world is torn down (every hero is gone, so the stat table is emptied)
+    void OnTeardown() override { m_statTable.Clear(); }
+    
+    // Give a hero a stat table row; its stats are recomputed in the next batch
+    void AttachStats(Entity entity) {
+        HeroComponent* hero = m_entityManager->GetComponent<HeroComponent>(entity);
+        if (hero) {
+            hero->m_statTable = &m_statTable;
+            hero->m_statRow = m_statTable.AddRow(entity);
+            hero->OnStatInputsChanged();
+        }
+    }
+    
+    // Release a hero's stat table row
+    void DetachStats(Entity entity) {
+        HeroComponent* hero = m_entityManager->GetComponent<HeroComponent>(entity);
+        if (hero && hero->m_statTable == &m_statTable) {
+            m_statTable.RemoveRow(hero->m_statRow);
+            hero->m_statTable = nullptr;
+            hero->m_statRow = HeroStatTable::INVALID_ROW;
+        }
+    }
+    
+    // Put a hero's cooldowns and status-effect expiries on the world's timing wheel (no-op outside a world)
+    void AttachTimers(Entity entity) {
+        HeroComponent* hero = m_entityManager->GetComponent<HeroComponent>(entity);
+        TimingWheel* timers = m_entityManager->GetTimers();
+        if (hero && timers && !hero->m_timers) {
+            hero->BindTimers(timers, m_entityManager, entity);
+        }
+    }
+    
+    // Take a hero's cooldowns and status effects off the timing wheel
+    void DetachTimers(Entity entity) {
+        HeroComponent* hero = m_entityManager->GetComponent<HeroComponent>(entity);
+        if (hero && hero->m_timers) {
+            hero->UnbindTimers();
+        }
+    }
+    
+    // Recompute the current stats of every hero whose level, base stats or modifiers changed,
+    // vectorized across heroes, and write them back to the components
+    void RecomputeStats() {
+        m_statTable.Recompute([this](Entity entity, uint32_t row) {
+            HeroComponent* hero = m_entityManager->GetComponent<HeroComponent>(entity);
+            if (hero) {
+                hero->m_currentStats = hero->m_baseStats;
+                m_statTable.ReadCurrent(row, hero->m_currentStats);
+            }
+        });
+    }
+    
+    // Get the stat table
+    const HeroStatTable& GetStatTable() const { return m_statTable; }
+    
     // Register a hero template
     void RegisterHeroTemplate(const std::string& name, const HeroComponent& heroTemplate);
     
-    // Get a hero template
+    // Get a hero template (this world's templates first, then the shared set)
     const HeroComponent* GetHeroTemplate(const std::string& name) const;
     
+    // Get the templates registered with this world
+    const HeroTemplateMap& GetHeroTemplates() const { return m_heroTemplates; }
+    
+    // Use a read-only template set shared between worlds
+    void SetSharedTemplates(std::shared_ptr<const HeroTemplateMap> templates) { m_sharedTemplates = std::move(templates); }
+    
+    // Get the shared template set
+    const std::shared_ptr<const HeroTemplateMap>& GetSharedTemplates() const { return m_sharedTemplates; }
+    
+    // Load hero templates once for sharing between worlds
+    static std::shared_ptr<const HeroTemplateMap> LoadSharedTemplatesFromFile(const std::string& filename);
+    
     // Create a hero from a template
     Entity CreateHero(const std::string& templateName);
     
+    // Record the creation of a hero from a template; returns a provisional handle valid until the next flush
+    Entity CreateHero(const std::string& templateName, EntityCommandBuffer& commands);
+    
     // Create a custom hero
     Entity CreateCustomHero(const std::string& name, const std::string& description, const std::string& role, const HeroStats& stats);
     
-    // Get active heroes
-    const std::vector<Entity>& GetActiveHeroes() const { return m_activeHeroes; }
+    // Get active heroes (cached, read-only query over every entity with a HeroComponent; iterating it
+    // does not mark the hero chunks changed)
+    ComponentView<const HeroComponent> GetActiveHeroes() const { return m_entityManager->View<const HeroComponent>(); }
     
     // Load hero templates from a JSON file
     bool LoadHeroTemplatesFromFile(const std::string& filename);
@@ -0,0 +1,335 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "../core/ecs.h"
+
+namespace CHULUBME {
+
+/**
+ * @brief Status effects a hero can carry; each one is a bit in a StatusEffectMask
+ */
+enum class StatusEffectType : uint8_t {
+    // Crowd control
+    Stun,
+    Root,
+    Silence,
+    Disarm,
+    Knockup,
+    Taunt,
+    Fear,
+    Blind,
+    Slow,
+    // Buffs
+    Haste,
+    Shield,
+    Invisible,
+    Invulnerable,
+    AttackSpeedBuff,
+    HealOverTime,
+    // Debuffs
+    DamageOverTime,
+    ArmorReduction,
+    MagicResistReduction,
+    GrievousWounds,
+    Count
+};
+
+// Number of status effect types
+constexpr size_t STATUS_EFFECT_COUNT = static_cast<size_t>(StatusEffectType::Count);
+
+// Set of status effect types
+using StatusEffectMask = uint64_t;
+
+static_assert(STATUS_EFFECT_COUNT <= 64, "StatusEffectMask holds one bit per status effect");
+
+// Get the bit of a status effect type
+constexpr StatusEffectMask StatusEffectBit(StatusEffectType type) { return StatusEffectMask{1} << static_cast<size_t>(type); }
+
+// Effects that stop movement, casting and basic attacks respectively
+constexpr StatusEffectMask STATUS_BLOCKS_MOVEMENT = StatusEffectBit(StatusEffectType::Stun) | StatusEffectBit(StatusEffectType::Root) |
+                                                    StatusEffectBit(StatusEffectType::Knockup) | StatusEffectBit(StatusEffectType::Taunt) |
+                                                    StatusEffectBit(StatusEffectType::Fear);
+constexpr StatusEffectMask STATUS_BLOCKS_CASTING = StatusEffectBit(StatusEffectType::Stun) | StatusEffectBit(StatusEffectType::Silence) |
+                                                   StatusEffectBit(StatusEffectType::Knockup) | StatusEffectBit(StatusEffectType::Taunt) |
+                                                   StatusEffectBit(StatusEffectType::Fear);
+constexpr StatusEffectMask STATUS_BLOCKS_ATTACKS = StatusEffectBit(StatusEffectType::Stun) | StatusEffectBit(StatusEffectType::Disarm) |
+                                                   StatusEffectBit(StatusEffectType::Knockup) | StatusEffectBit(StatusEffectType::Fear);
+
+/**
+ * @brief What happens when an effect is applied to a hero that already has it
+ */
+enum class StatusStackRule : uint8_t {
+    // Duration restarts at the longer of the two; magnitude is replaced
+    Refresh,
+    // New duration is added to what is left
+    Extend,
+    // One more stack (up to maxStacks) with the duration refreshed; magnitude is per stack
+    Stack,
+    // The stronger application wins; a weaker one is ignored unless it outlasts the current one, in
+    // which case it is kept as the fallback and takes over when the stronger one expires (one
+    // fallback per effect, the strongest of those that outlast the current application)
+    KeepStrongest
+};
+
+/**
+ * @brief Catalogue entry of a status effect
+ */
+struct StatusEffectDefinition {
+    const char* name;
+    StatusStackRule stackRule;
+    uint8_t maxStacks;
+    bool isCrowdControl;
+    bool isDebuff;
+};
+
+/**
+ * @brief Process-wide, enum-indexed definitions of every status effect
+ *
+ * Defaults are built in; Register overrides one at load time (e.g. from
+ * balance data) and must not race with gameplay.
+ */
+class StatusEffectCatalogue {
+private:
+    static StatusEffectDefinition* Definitions() {
+        static StatusEffectDefinition s_definitions[STATUS_EFFECT_COUNT] = {
+            {"Stun", StatusStackRule::Refresh, 1, true, true},
+            {"Root", StatusStackRule::Refresh, 1, true, true},
+            {"Silence", StatusStackRule::Refresh, 1, true, true},
+            {"Disarm", StatusStackRule::Refresh, 1, true, true},
+            {"Knockup", StatusStackRule::Refresh, 1, true, true},
+            {"Taunt", StatusStackRule::Refresh, 1, true, true},
+            {"Fear", StatusStackRule::Refresh, 1, true, true},
+            {"Blind", StatusStackRule::Refresh, 1, true, true},
+            {"Slow", StatusStackRule::KeepStrongest, 1, true, true},
+            {"Haste", StatusStackRule::KeepStrongest, 1, false, false},
+            {"Shield", StatusStackRule::Refresh, 1, false, false},
+            {"Invisible", StatusStackRule::Refresh, 1, false, false},
+            {"Invulnerable", StatusStackRule::Refresh, 1, false, false},
+            {"AttackSpeedBuff", StatusStackRule::Stack, 5, false, false},
+            {"HealOverTime", StatusStackRule::Extend, 1, false, false},
+            {"DamageOverTime", StatusStackRule::Stack, 3, false, true},
+            {"ArmorReduction", StatusStackRule::Stack, 4, false, true},
+            {"MagicResistReduction", StatusStackRule::Stack, 4, false, true},
+            {"GrievousWounds", StatusStackRule::KeepStrongest, 1, false, true},
+        };
+        return s_definitions;
+    }
+
+public:
+    // Get the definition of an effect
+    static const StatusEffectDefinition& Get(StatusEffectType type) { return Definitions()[static_cast<size_t>(type)]; }
+
+    // Replace the definition of an effect (load time only; name must stay valid)
+    static void Register(StatusEffectType type, const StatusEffectDefinition& definition) {
+        Definitions()[static_cast<size_t>(type)] = definition;
+    }
+
+    // Get every crowd-control effect
+    static StatusEffectMask GetCrowdControlMask() {
+        StatusEffectMask mask = 0;
+        for (size_t i = 0; i < STATUS_EFFECT_COUNT; ++i) {
+            mask |= Definitions()[i].isCrowdControl ? StatusEffectBit(static_cast<StatusEffectType>(i)) : 0;
+        }
+        return mask;
+    }
+
+    // Find an effect by name (tooling); returns false if there is none
+    static bool Find(const std::string& name, StatusEffectType& type) {
+        for (size_t i = 0; i < STATUS_EFFECT_COUNT; ++i) {
+            if (name == Definitions()[i].name) {
+                type = static_cast<StatusEffectType>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief One active status effect on a hero
+ */
+struct StatusEffectSlot {
+    float remaining;
+    float magnitude;
+    Entity source;
+    uint8_t stacks;
+
+    // Weaker, longer KeepStrongest application that takes over when this one expires (none if
+    // fallbackRemaining is not above remaining)
+    float fallbackRemaining;
+    float fallbackMagnitude;
+    Entity fallbackSource;
+};
+
+/**
+ * @brief A hero's active status effects
+ *
+ * One slot per effect type, indexed by the enum, plus a bitmask of the
+ * active ones: checks like "is stunned" or "can cast" are a single AND, and
+ * adding, removing or ticking an effect never allocates or searches. Tick
+ * only visits active effects. An owner that schedules expiries itself (a
+ * hero in a world, on the world's timing wheel) never calls Tick: it
+ * catches remaining times up with Elapse before changing the set and ends
+ * each application with Expire when its timer fires.
+ */
+class StatusEffectSet {
+private:
+    StatusEffectMask m_active;
+    StatusEffectSlot m_slots[STATUS_EFFECT_COUNT];
+
+    static bool HasFallback(const StatusEffectSlot& slot) { return slot.fallbackRemaining > slot.remaining; }
+
+    // End a slot's current application: its fallback takes over if it has time left, otherwise the
+    // effect expires. Returns true if it expired.
+    bool Finish(size_t index) {
+        StatusEffectSlot& slot = m_slots[index];
+        if (HasFallback(slot) && slot.fallbackRemaining > 0.0f) {
+            slot.remaining = slot.fallbackRemaining;
+            slot.magnitude = slot.fallbackMagnitude;
+            slot.source = slot.fallbackSource;
+            slot.fallbackRemaining = 0.0f;
+            return false;
+        }
+        m_active &= ~(StatusEffectMask{1} << index);
+        return true;
+    }
+
+    // Keep a KeepStrongest application as the slot's fallback if it outlasts the current one and
+    // beats the fallback already kept
+    static void OfferFallback(StatusEffectSlot& slot, float duration, float magnitude, Entity source) {
+        if (duration <= slot.remaining) {
+            return;
+        }
+        if (!HasFallback(slot) || magnitude > slot.fallbackMagnitude ||
+            (magnitude == slot.fallbackMagnitude && duration > slot.fallbackRemaining)) {
+            slot.fallbackRemaining = duration;
+            slot.fallbackMagnitude = magnitude;
+            slot.fallbackSource = source;
+        }
+    }
+
+public:
+    StatusEffectSet() { Clear(); }
+
+    // Apply an effect following its catalogue stacking rule; magnitude means per stack for Stack effects
+    void Apply(StatusEffectType type, float duration, float magnitude = 0.0f, Entity source = Entity()) {
+        StatusEffectSlot& slot = m_slots[static_cast<size_t>(type)];
+        StatusEffectMask bit = StatusEffectBit(type);
+        if (!(m_active & bit)) {
+            m_active |= bit;
+            slot = StatusEffectSlot{duration, magnitude, source, 1, 0.0f, 0.0f, Entity()};
+            return;
+        }
+
+        const StatusEffectDefinition& definition = StatusEffectCatalogue::Get(type);
+        switch (definition.stackRule) {
+            case StatusStackRule::Refresh:
+                slot.remaining = duration > slot.remaining ? duration : slot.remaining;
+                slot.magnitude = magnitude;
+                slot.source = source;
+                break;
+            case StatusStackRule::Extend:
+                slot.remaining += duration;
+                slot.source = source;
+                break;
+            case StatusStackRule::Stack:
+                slot.stacks = slot.stacks < definition.maxStacks ? static_cast<uint8_t>(slot.stacks + 1) : slot.stacks;
+                slot.remaining = duration;
+                slot.magnitude = magnitude;
+                slot.source = source;
+                break;
+            case StatusStackRule::KeepStrongest:
+                if (magnitude > slot.magnitude || (magnitude == slot.magnitude && duration > slot.remaining)) {
+                    // The replaced application may still outlast the new one
+                    StatusEffectSlot previous = slot;
+                    slot.remaining = duration;
+                    slot.magnitude = magnitude;
+                    slot.source = source;
+                    if (!HasFallback(slot)) {
+                        slot.fallbackRemaining = 0.0f;
+                    }
+                    OfferFallback(slot, previous.remaining, previous.magnitude, previous.source);
+                } else {
+                    OfferFallback(slot, duration, magnitude, source);
+                }
+                break;
+        }
+    }
+
+    // Remove an effect
+    void Remove(StatusEffectType type) { m_active &= ~StatusEffectBit(type); }
+
+    // Remove every effect in a mask (e.g. a cleanse removing crowd control)
+    void RemoveAll(StatusEffectMask mask) { m_active &= ~mask; }
+
+    // Remove every effect
+    void Clear() {
+        m_active = 0;
+        for (StatusEffectSlot& slot : m_slots) {
+            slot = StatusEffectSlot{0.0f, 0.0f, Entity(), 0, 0.0f, 0.0f, Entity()};
+        }
+    }
+
+    // Check if an effect is active
+    bool Has(StatusEffectType type) const { return (m_active & StatusEffectBit(type)) != 0; }
+
+    // Check if any effect in a mask is active
+    bool HasAny(StatusEffectMask mask) const { return (m_active & mask) != 0; }
+
+    // Get the active effects
+    StatusEffectMask GetMask() const { return m_active; }
+
+    // Get an active effect's slot, or null
+    const StatusEffectSlot* Get(StatusEffectType type) const { return Has(type) ? &m_slots[static_cast<size_t>(type)] : nullptr; }
+
+    // Get an effect's total magnitude (per-stack magnitude times stacks for Stack effects; 0 if inactive)
+    float GetMagnitude(StatusEffectType type) const {
+        const StatusEffectSlot* slot = Get(type);
+        if (!slot) {
+            return 0.0f;
+        }
+        return StatusEffectCatalogue::Get(type).stackRule == StatusStackRule::Stack ? slot->magnitude * slot->stacks : slot->magnitude;
+    }
+
+    // Get the time left on an active effect's current application (0 if inactive)
+    float GetRemaining(StatusEffectType type) const {
+        const StatusEffectSlot* slot = Get(type);
+        return slot ? slot->remaining : 0.0f;
+    }
+
+    // Count down every active effect; returns the effects that expired. A KeepStrongest effect whose
+    // fallback outlasts it continues as the fallback instead of expiring.
+    StatusEffectMask Tick(float deltaTime) {
+        StatusEffectMask expired = 0;
+        for (size_t index = 0; (m_active >> index) != 0; ++index) {
+            if (!(m_active >> index & 1)) {
+                continue;
+            }
+            StatusEffectSlot& slot = m_slots[index];
+            slot.remaining -= deltaTime;
+            slot.fallbackRemaining -= deltaTime;
+            if (slot.remaining <= 0.0f && Finish(index)) {
+                expired |= StatusEffectMask{1} << index;
+            }
+        }
+        return expired;
+    }
+
+    // Count down every active effect without expiring any (for owners that schedule expiries)
+    void Elapse(float deltaTime) {
+        for (size_t index = 0; (m_active >> index) != 0; ++index) {
+            if (m_active >> index & 1) {
+                m_slots[index].remaining -= deltaTime;
+                m_slots[index].fallbackRemaining -= deltaTime;
+            }
+        }
+    }
+
+    // End an effect's current application now, as its expiry timer fires; a fallback with time left
+    // takes over. Returns true if the effect is no longer active.
+    bool Expire(StatusEffectType type) { return !Has(type) || Finish(static_cast<size_t>(type)); }
+};
+
+} // namespace CHULUBME
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <unordered_map>
 #include "../core/ecs.h"
 
@@ -14,9 +15,14 @@ class Texture;
 class Mesh;
 class Material;
 class Camera;
+class JobSystem;
 
 /**
  * @brief Transform component for positioning entities in 3D space
+ *
+ * Keeps the state of the previous simulation tick next to the current one
+ * so rendering can interpolate between them when the simulation runs at a
+ * lower rate than the display.
  */
 class TransformComponent : public Component {
 private:
@@ -25,6 +31,11 @@ private:
     float m_rotation[3];
     float m_scale[3];
     
+    // Position, rotation, and scale at the start of the current tick
+    float m_previousPosition[3];
+    float m_previousRotation[3];
+    float m_previousScale[3];
+    
     // Parent transform
     Entity m_parent;
     
@@ -88,6 +99,77 @@ public:
     
     // Check if the transform is dirty
     bool IsDirty() const { return m_dirty; }
+    
+    // Copy the current state into the previous-tick state (called at the start of each tick)
+    void SavePreviousState() {
+        for (int i = 0; i < 3; ++i) {
+            m_previousPosition[i] = m_position[i];
+            m_previousRotation[i] = m_rotation[i];
+            m_previousScale[i] = m_scale[i];
+        }
+    }
+    
+    // Snap the previous-tick state to the current one (teleports, spawns)
+    void ResetInterpolation() { SavePreviousState(); }
+    
+    // Get position at the start of the current tick
+    const float* GetPreviousPosition() const { return m_previousPosition; }
+    
+    // Get rotation at the start of the current tick
+    const float* GetPreviousRotation() const { return m_previousRotation; }
+    
+    // Get scale at the start of the current tick
+    const float* GetPreviousScale() const { return m_previousScale; }
+    
+    // Get position blended between the previous (alpha 0) and current (alpha 1) tick
+    void GetInterpolatedPosition(float alpha, float out[3]) const {
+        for (int i = 0; i < 3; ++i) {
+            out[i] = m_previousPosition[i] + (m_position[i] - m_previousPosition[i]) * alpha;
+        }
+    }
+    
+    // Get rotation blended between the previous and current tick along the shorter arc of each angle
+    void GetInterpolatedRotation(float alpha, float out[3]) const {
+        for (int i = 0; i < 3; ++i) {
+            float delta = m_rotation[i] - m_previousRotation[i];
+            while (delta > 180.0f) delta -= 360.0f;
+            while (delta < -180.0f) delta += 360.0f;
+            out[i] = m_previousRotation[i] + delta * alpha;
+        }
+    }
+    
+    // Get scale blended between the previous and current tick
+    void GetInterpolatedScale(float alpha, float out[3]) const {
+        for (int i = 0; i < 3; ++i) {
+            out[i] = m_previousScale[i] + (m_scale[i] - m_previousScale[i]) * alpha;
+        }
+    }
+    
+    // Get the world matrix of the interpolated position, rotation and scale
+    void GetInterpolatedWorldMatrix(float alpha, float out[16]) const;
+};
+
+/**
+ * @brief Saves each transform's previous-tick state before the tick's systems move it
+ *
+ * Register before any system that writes TransformComponent in FixedUpdate:
+ * the scheduler orders conflicting systems by registration, so the snapshot
+ * always runs first in the tick. Only chunks whose transforms changed since
+ * the last snapshot are visited. Headless servers do not need it.
+ */
+class TransformHistorySystem : public System {
+public:
+    TransformHistorySystem(EntityManager* manager) : System(manager) {
+        SetSignature<TransformComponent>();
+        Writes<TransformComponent>();
+    }
+    
+    // Snapshot the transforms that moved during the previous tick
+    void FixedUpdate(float) override {
+        Query<Changed<TransformComponent>>().Each([](Entity, TransformComponent& transform) {
+            transform.SavePreviousState();
+        });
+    }
 };
 
 /**
@@ -164,6 +246,10 @@ public:
     bool IsDirty() const { return m_dirty; }
 };
 
+// Cameras hold only plain data, so teardown drops them without running destructors
+template<>
+struct SkipDestructorOnTeardown<CameraComponent> : std::true_type {};
+
 /**
  * @brief Mesh renderer component for rendering 3D meshes
  */
@@ -215,29 +301,33 @@ private:
     // Main camera
     Entity m_mainCamera;
     
-    // Render queue
+    // Blend between the previous and current simulation tick for this frame
+    float m_interpolationAlpha;
+    
+    // Render queue, filled each Update from the cached MeshRenderer/Transform view
     struct RenderQueueItem {
         Entity entity;
         MeshRendererComponent* meshRenderer;
         TransformComponent* transform;
     };
     
-    std::vector<RenderQueueItem> m_renderQueue;
+    std::pmr::vector<RenderQueueItem> m_renderQueue;
     
     // Shaders
-    std::unordered_map<std::string, std::shared_ptr<Shader>> m_shaders;
+    std::pmr::unordered_map<std::string, std::shared_ptr<Shader>> m_shaders;
     
     // Textures
-    std::unordered_map<std::string, std::shared_ptr<Texture>> m_textures;
+    std::pmr::unordered_map<std::string, std::shared_ptr<Texture>> m_textures;
     
     // Meshes
-    std::unordered_map<std::string, std::shared_ptr<Mesh>> m_meshes;
+    std::pmr::unordered_map<std::string, std::shared_ptr<Mesh>> m_meshes;
     
     // Materials
-    std::unordered_map<std::string, std::shared_ptr<Material>> m_materials;
+    std::pmr::unordered_map<std::string, std::shared_ptr<Material>> m_materials;
 
 public:
-    RenderSystem(EntityManager* manager);
+    // Create the render system; the render queue and resource maps allocate from resource
+    RenderSystem(EntityManager* manager, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     ~RenderSystem() override;
     
     // Initialize the system
@@ -261,6 +351,12 @@ public:
     // Get main camera
     Entity GetMainCamera() const { return m_mainCamera; }
     
+    // Set the interpolation alpha used to place transforms this frame (World::GetInterpolationAlpha)
+    void SetInterpolationAlpha(float alpha) { m_interpolationAlpha = alpha; }
+    
+    // Get the interpolation alpha
+    float GetInterpolationAlpha() const { return m_interpolationAlpha; }
+    
     // Load a shader
     std::shared_ptr<Shader> LoadShader(const std::string& name, const std::string& vertexPath, const std::string& fragmentPath);
     
@@ -270,12 +366,18 @@ public:
     // Load a texture
     std::shared_ptr<Texture> LoadTexture(const std::string& name, const std::string& path);
     
+    // Load several textures (name, path), decoding them in parallel on the job system
+    void LoadTextures(const std::vector<std::pair<std::string, std::string>>& textures, JobSystem& jobSystem);
+    
     // Get a texture
     std::shared_ptr<Texture> GetTexture(const std::string& name) const;
     
     // Load a mesh
     std::shared_ptr<Mesh> LoadMesh(const std::string& name, const std::string& path);
     
+    // Load several meshes (name, path), parsing them in parallel on the job system
+    void LoadMeshes(const std::vector<std::pair<std::string, std::string>>& meshes, JobSystem& jobSystem);
+    
     // Get a mesh
     std::shared_ptr<Mesh> GetMesh(const std::string& name) const;
     